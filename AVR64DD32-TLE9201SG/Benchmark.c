@@ -0,0 +1,310 @@
+/**
+ * @file Benchmark.c
+ * @brief Cycle-count benchmark of the driver entry points.
+ *
+ * @details Runs every case of BENCHMARK_Result (a grid of functions, TCD0 clock
+ *          sources, frequencies and duty cycles) and stores the measured cycles next
+ *          to the baseline from BenchmarkVar.h. Stack depth and the flash/SRAM footprint
+ *          go to BENCHMARK_Summary. Both tables are then reported over USART1 once a
+ *          second for Tools/benchmark.py, which prints them and exits non-zero on FAIL.
+ *          Compiled in only when BENCHMARK is defined (see Settings.h).
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+
+#ifdef BENCHMARK
+
+#include "BenchmarkVar.h"
+
+extern uint8_t __heap_start;    ///< First SRAM byte after .data and .bss (linker symbol).
+extern uint8_t __data_load_end; ///< End of the flash image (linker symbol).
+
+/**
+ * @brief Fills the free SRAM between static data and the stack with BENCHMARK_STACK_PAINT.
+ *
+ * @note Must run with interrupts disabled.
+ */
+void BENCHMARK_Paint() {
+    uint8_t *ram = &__heap_start;
+    uint8_t *stack = (uint8_t *)SP;
+    while (ram < stack) {
+        *ram++ = BENCHMARK_STACK_PAINT;
+    }
+}
+
+/**
+ * @brief Finds the deepest stack use since BENCHMARK_Paint().
+ *
+ * @return Stack depth in bytes.
+ */
+uint16_t BENCHMARK_Stack() {
+    uint8_t *ram = &__heap_start;
+    while (ram <= (uint8_t *)RAMEND && *ram == BENCHMARK_STACK_PAINT) {
+        ram++;
+    }
+    return RAMEND - (uint16_t)ram + 1;
+}
+
+/**
+ * @brief Selects the TCD0 clock source and prescaler for a case.
+ *
+ * @details The prescaler is the smallest one that keeps the double slope period of
+ *          the case within 12 bits, so PWM_init() times a valid configuration.
+ *
+ * @param clock TCD_CLKSEL_OSCHF_gc or TCD_CLKSEL_PLL_gc.
+ * @param freq PWM frequency of the case in Hz, 0 if it does not use the PWM.
+ */
+void BENCHMARK_Clock(uint8_t clock, uint32_t freq) {
+    uint32_t source = (clock == TCD_CLKSEL_PLL_gc) ? CLOCK_Tree.pll : CLOCK_Tree.oschf;
+    uint8_t ctrla = clock | (freq ? PWM_prescaler(source, freq, TCD_WGMODE_DS_gc) : TCD_CNTPRES_DIV1_gc);
+    if ((TCD0.CTRLA & (TCD_CLKSEL_gm | TCD_SYNCPRES_gm | TCD_CNTPRES_gm)) != ctrla) {
+        TCD0_OFF();
+        while (!(TCD0.STATUS & TCD_ENRDY_bm)); ///< Wait until TCD is ready for configuration
+        TCD0.CTRLA = ctrla;
+        CLOCK_update();
+    }
+}
+
+/**
+ * @brief Runs one benchmark case.
+ *
+ * @details Only the call itself is timed; setup for the case is done before reading
+ *          the cycle counter. Interrupts are disabled except for the SPI0 exchange,
+ *          which needs the SPI0 interrupt to finish.
+ *
+ * @param result Case to run.
+ * @return Cycles between the two counter reads, measurement overhead included.
+ */
+uint16_t BENCHMARK_Case(BENCHMARK_RESULT *result) {
+    uint16_t start = 0;
+    uint16_t stop = 0;
+    volatile uint32_t sink;
+
+    switch (result->function) {
+        case BENCHMARK_PWM_INIT:
+            cli();
+            start = TCB1_CYCLES();
+            PWM_init(result->freq, result->param);
+            stop = TCB1_CYCLES();
+            sei();
+            break;
+        case BENCHMARK_PWM_SET_DUTY:
+            PWM_init(result->freq, 0);
+            cli();
+            start = TCB1_CYCLES();
+            PWM_set_duty(result->param);
+            stop = TCB1_CYCLES();
+            sei();
+            break;
+        case BENCHMARK_CLOCK_UPDATE:
+            cli();
+            start = TCB1_CYCLES();
+            CLOCK_update();
+            stop = TCB1_CYCLES();
+            sei();
+            break;
+        case BENCHMARK_CLOCK_READ:
+            cli();
+            start = TCB1_CYCLES();
+            sink = CLOCK_read();
+            stop = TCB1_CYCLES();
+            sei();
+            (void)sink;
+            break;
+        case BENCHMARK_SORT_DIAGNOSIS:
+            TLE9201SG.diag = result->param;
+            cli();
+            start = TCB1_CYCLES();
+            TLE9201SG_Sort_Diagnosis();
+            stop = TCB1_CYCLES();
+            sei();
+            break;
+        case BENCHMARK_WRITE:
+            TLE9201SG.control = result->param;
+            cli();
+            start = TCB1_CYCLES();
+            sink = TLE9201SG_Write(WR_CTRL_RD_DIA);
+            stop = TCB1_CYCLES();
+            sei();
+            break;
+        case BENCHMARK_START:
+            TLE9201SG_OFF();
+            PWM_init(result->freq, result->param);
+            cli();
+            start = TCB1_CYCLES();
+            TLE9201SG_START();
+            stop = TCB1_CYCLES();
+            sei();
+            break;
+        case BENCHMARK_STOP:
+            PWM_init(result->freq, result->param);
+            TLE9201SG_START();
+            cli();
+            start = TCB1_CYCLES();
+            TLE9201SG_STOP();
+            stop = TCB1_CYCLES();
+            sei();
+            break;
+        case BENCHMARK_SPI_EXCHANGE:
+            start = TCB1_CYCLES();
+            SPI0_Exchange_Data(result->param);
+            stop = TCB1_CYCLES();
+            break;
+#ifdef CURRENT_CONTROL
+        case BENCHMARK_CURRENT_STEP:
+            PWM_init(result->freq, 0);
+            CURRENT_Loop.limit = 0xFFFF;
+            CURRENT_Loop.integral = 0x8000;
+            cli();
+            start = TCB1_CYCLES();
+            PWM_set_duty(CURRENT_Regulate(result->param));
+            CURRENT_Delay();
+            stop = TCB1_CYCLES();
+            sei();
+            break;
+#endif
+        case BENCHMARK_PID_STEP:
+            PWM_init(result->freq, 0);
+            PID_Speed.limit = 0xFFFF;
+            PID_Speed.integral = (int32_t)0x8000 << PID_GAIN_SHIFT;
+            PID_Speed.measured = 1000;
+            cli();
+            start = TCB1_CYCLES();
+            TLE9201SG_Drive(PID_Step(result->param));
+            stop = TCB1_CYCLES();
+            sei();
+            break;
+    }
+    return stop - start;
+}
+
+/**
+ * @brief Stores a value little endian in a record.
+ *
+ * @param record Record being built.
+ * @param at Index of the first byte.
+ * @param value Value to store.
+ * @param bytes Number of bytes (1, 2 or 4).
+ * @return Index after the value.
+ */
+uint8_t BENCHMARK_Put(uint8_t *record, uint8_t at, uint32_t value, uint8_t bytes) {
+    for (uint8_t i = 0; i < bytes; i++) {
+        record[at++] = value >> (8 * i);
+    }
+    return at;
+}
+
+/**
+ * @brief Sends one record in telemetry framing (CRC, COBS, delimiter).
+ *
+ * @details Waits for the previous frame to leave the encode buffer first.
+ *
+ * @param record Record with 2 spare bytes for the CRC.
+ * @param length Record length without the CRC.
+ */
+void BENCHMARK_Send(uint8_t *record, uint8_t length) {
+    static uint8_t frame[BENCHMARK_RECORD_SIZE + 2 + 1 + 1];
+
+    while (USART1_Busy()) {}
+    uint16_t crc = TELEMETRY_CRC(record, length);
+    length = BENCHMARK_Put(record, length, crc, 2);
+    USART1_Send(frame, TELEMETRY_Encode(record, length, frame));
+}
+
+/**
+ * @brief Sends every case record and the summary record once.
+ */
+void BENCHMARK_Report() {
+    uint8_t record[BENCHMARK_RECORD_SIZE + 2];
+
+    for (uint8_t i = 0; i < BENCHMARK_CASES; i++) {
+        const BENCHMARK_RESULT *result = &BENCHMARK_Result[i];
+        uint8_t n = 0;
+        record[n++] = BENCHMARK_TYPE_CASE;
+        record[n++] = i;
+        record[n++] = BENCHMARK_CASES;
+        record[n++] = result->function;
+        record[n++] = result->clock;
+        n = BENCHMARK_Put(record, n, result->freq, 4);
+        n = BENCHMARK_Put(record, n, result->param, 2);
+        n = BENCHMARK_Put(record, n, result->baseline, 2);
+        n = BENCHMARK_Put(record, n, result->cycles, 2);
+        BENCHMARK_Send(record, n);
+    }
+
+    uint8_t n = 0;
+    record[n++] = BENCHMARK_TYPE_SUMMARY;
+    record[n++] = BENCHMARK_Summary.status;
+    record[n++] = BENCHMARK_Summary.regressions;
+    record[n++] = BENCHMARK_TOLERANCE;
+    n = BENCHMARK_Put(record, n, BENCHMARK_Summary.overhead, 2);
+    n = BENCHMARK_Put(record, n, BENCHMARK_Summary.stack, 2);
+    n = BENCHMARK_Put(record, n, BENCHMARK_Summary.flash, 2);
+    n = BENCHMARK_Put(record, n, BENCHMARK_Summary.ram, 2);
+    BENCHMARK_Send(record, n);
+}
+
+/**
+ * @brief Runs the whole benchmark and reports the results.
+ *
+ * @details Sets up PWM/DIR mode hardware, measures the overhead of an empty
+ *          measurement, runs every case, compares it with its baseline and records
+ *          stack depth and memory footprint. Then sends the results over USART1
+ *          every BENCHMARK_REPORT_TICKS, so the host may connect at any time.
+ *          Never returns.
+ *
+ * @note Call from main() after the clock, the RTC tick and USART1 are set up and
+ *       interrupts are enabled.
+ */
+void BENCHMARK_run() {
+    cli();
+    BENCHMARK_Paint();
+    sei();
+
+    TCB1_Cycle_init();
+    PLL_init();
+    TCD0_init();
+    SPI0_init();
+    TLE9201SG.mode = TLE9201SG_MODE_PWMDIR;
+
+    // Cycles of two back-to-back counter reads
+    cli();
+    uint16_t start = TCB1_CYCLES();
+    uint16_t stop = TCB1_CYCLES();
+    sei();
+    BENCHMARK_Summary.overhead = stop - start;
+
+    for (uint8_t i = 0; i < BENCHMARK_CASES; i++) {
+        BENCHMARK_RESULT *result = &BENCHMARK_Result[i];
+        BENCHMARK_Clock(result->clock, result->freq);
+        result->cycles = BENCHMARK_Case(result) - BENCHMARK_Summary.overhead;
+        if (result->baseline &&
+            result->cycles > result->baseline + (uint32_t)result->baseline * BENCHMARK_TOLERANCE / 100) {
+            BENCHMARK_Summary.regressions++;
+        }
+    }
+    TLE9201SG_OFF();
+
+    BENCHMARK_Summary.stack = BENCHMARK_Stack();
+    BENCHMARK_Summary.flash = (uint16_t)&__data_load_end;
+    BENCHMARK_Summary.ram = (uint16_t)&__heap_start - RAMSTART;
+    BENCHMARK_Summary.status = BENCHMARK_Summary.regressions ? BENCHMARK_FAIL : BENCHMARK_PASS;
+
+    uint32_t due = RTC_Ticks;
+    while (1) {
+        uint32_t now;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            now = RTC_Ticks;
+        }
+        if ((int32_t)(now - due) >= 0) {
+            due = now + BENCHMARK_REPORT_TICKS;
+            BENCHMARK_Report();
+        }
+        sleep_mode(); // Woken by the RTC tick
+    }
+}
+
+#endif /* BENCHMARK */
@@ -0,0 +1,116 @@
+/**
+ * @file Benchmark.h
+ * @brief Header file for the cycle-count benchmark of the driver entry points.
+ *
+ * @details Compiled in only when BENCHMARK is defined (see Settings.h). Every case is
+ *          timed with the free-running TCB1 cycle counter and written to
+ *          BENCHMARK_Result. The results are then sent over USART1 once a second in
+ *          telemetry framing; Tools/benchmark.py prints them and fails on a regression.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+/** @brief Benchmarked function: PWM_init(). */
+#define BENCHMARK_PWM_INIT 0
+
+/** @brief Benchmarked function: PWM_set_duty(). */
+#define BENCHMARK_PWM_SET_DUTY 1
+
+/** @brief Benchmarked function: CLOCK_update(). */
+#define BENCHMARK_CLOCK_UPDATE 2
+
+/** @brief Benchmarked function: CLOCK_read(). */
+#define BENCHMARK_CLOCK_READ 3
+
+/** @brief Benchmarked function: TLE9201SG_Sort_Diagnosis(). */
+#define BENCHMARK_SORT_DIAGNOSIS 4
+
+/** @brief Benchmarked function: TLE9201SG_Write(). */
+#define BENCHMARK_WRITE 5
+
+/** @brief Benchmarked function: TLE9201SG_START() in PWM/DIR mode. */
+#define BENCHMARK_START 6
+
+/** @brief Benchmarked function: TLE9201SG_STOP() in PWM/DIR mode. */
+#define BENCHMARK_STOP 7
+
+/** @brief Benchmarked function: SPI0_Exchange_Data(). */
+#define BENCHMARK_SPI_EXCHANGE 8
+
+/** @brief Benchmarked function: current regulator step (body of the ADC0 result interrupt). */
+#define BENCHMARK_CURRENT_STEP 9
+
+/** @brief Benchmarked function: speed controller step, PID_Step() and TLE9201SG_Drive(). */
+#define BENCHMARK_PID_STEP 10
+
+/** @brief Number of benchmark cases in BENCHMARK_Result. */
+#ifdef CURRENT_CONTROL
+#define BENCHMARK_CASES 27
+#else
+#define BENCHMARK_CASES 25 // Without the current regulator cases
+#endif
+
+/** @brief Percent a case may exceed its baseline before it counts as a regression. */
+#define BENCHMARK_TOLERANCE 10
+
+/** @brief Frame type of a case record: type, index, BENCHMARK_CASES, function, clock, freq u32, param, baseline, cycles u16. */
+#define BENCHMARK_TYPE_CASE 0x02
+
+/** @brief Frame type of the summary record: type, status, regressions, BENCHMARK_TOLERANCE, overhead, stack, flash, ram u16. */
+#define BENCHMARK_TYPE_SUMMARY 0x03
+
+/** @brief Largest record in bytes (a case record). */
+#define BENCHMARK_RECORD_SIZE 15
+
+/** @brief RTC ticks between two reports of the results. */
+#define BENCHMARK_REPORT_TICKS RTC_TICK_HZ
+
+/** @brief Byte used to paint free SRAM for the stack depth measurement. */
+#define BENCHMARK_STACK_PAINT 0xC5
+
+/** @brief Benchmark status: still running. */
+#define BENCHMARK_RUNNING 0
+
+/** @brief Benchmark status: every case with a baseline within it (cases with baseline 0 are not checked). */
+#define BENCHMARK_PASS 1
+
+/** @brief Benchmark status: at least one case slower than its baseline plus BENCHMARK_TOLERANCE. */
+#define BENCHMARK_FAIL 2
+
+/**
+ * @struct BENCHMARK_RESULT
+ * @brief One benchmark case: parameters, baseline and measured cycles.
+ */
+typedef struct {
+    uint8_t function;  ///< Benchmarked function (BENCHMARK_* id).
+    uint8_t clock;     ///< TCD0 clock source (TCD_CLKSEL_OSCHF_gc or TCD_CLKSEL_PLL_gc).
+    uint32_t freq;     ///< PWM frequency in Hz (PWM cases).
+    uint16_t param;    ///< Duty cycle, diagnosis/control byte or SPI frame, depending on the function.
+    uint16_t baseline; ///< Expected cycles, 0 if not checked.
+    uint16_t cycles;   ///< Measured cycles.
+} BENCHMARK_RESULT;
+
+/**
+ * @struct BENCHMARK_SUMMARY
+ * @brief Overall benchmark outcome and memory footprint.
+ */
+typedef struct {
+    uint8_t status;      ///< BENCHMARK_RUNNING, BENCHMARK_PASS or BENCHMARK_FAIL.
+    uint8_t regressions; ///< Cases slower than their baseline plus BENCHMARK_TOLERANCE.
+    uint16_t overhead;   ///< Cycles of an empty measurement, subtracted from every case.
+    uint16_t stack;      ///< Deepest stack use in bytes seen during the run.
+    uint16_t flash;      ///< Flash used by code and initialized data in bytes.
+    uint16_t ram;        ///< SRAM used by static data in bytes.
+} BENCHMARK_SUMMARY;
+
+/** @brief Benchmark cases with their baselines; cycles are filled in by BENCHMARK_run(). */
+extern BENCHMARK_RESULT BENCHMARK_Result[BENCHMARK_CASES];
+
+/** @brief Benchmark outcome and memory footprint. */
+extern BENCHMARK_SUMMARY BENCHMARK_Summary;
+
+#endif /* BENCHMARK_H_ */
@@ -0,0 +1,68 @@
+/**
+ * @file BenchmarkVar.h
+ * @brief Benchmark cases and their baselines.
+ *
+ * @details This is the baseline file of the benchmark: each row is one case of the
+ *          parameter grid (function, TCD0 clock source, frequency, parameter) followed
+ *          by the expected number of cycles. A case more than BENCHMARK_TOLERANCE percent
+ *          above it is a regression; a baseline of 0 is not checked.
+ *          No baseline has been measured on the hardware yet, so all are 0. Run the
+ *          benchmark image on a board and let
+ *          `Tools/benchmark.py --update BenchmarkVar.h <port>` write the measured cycles
+ *          into the baseline column, then commit them; repeat after a reviewed change
+ *          that is meant to alter the timing.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef BENCHMARKVAR_H_
+#define BENCHMARKVAR_H_
+
+#include "Benchmark.h" ///< Include the header file for the BENCHMARK_RESULT structure definition.
+
+/**
+ * @brief Global instance of the benchmark case table.
+ *
+ * @details Columns: function, clock, freq, param, baseline, cycles (measured).
+ */
+BENCHMARK_RESULT BENCHMARK_Result[BENCHMARK_CASES] = {
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_OSCHF_gc,    1000UL, PWM_DUTY_PERCENT(10),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_OSCHF_gc,    1000UL, PWM_DUTY_PERCENT(90),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_OSCHF_gc,   20000UL, PWM_DUTY_PERCENT(10),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_OSCHF_gc,   20000UL, PWM_DUTY_PERCENT(90),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_OSCHF_gc,   50000UL, PWM_DUTY_PERCENT(10),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_OSCHF_gc,   50000UL, PWM_DUTY_PERCENT(90),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_PLL_gc,      1000UL, PWM_DUTY_PERCENT(10),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_PLL_gc,      1000UL, PWM_DUTY_PERCENT(90),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_PLL_gc,     20000UL, PWM_DUTY_PERCENT(10),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_PLL_gc,     20000UL, PWM_DUTY_PERCENT(90),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_PLL_gc,     50000UL, PWM_DUTY_PERCENT(10),    0, 0 },
+    { BENCHMARK_PWM_INIT,       TCD_CLKSEL_PLL_gc,     50000UL, PWM_DUTY_PERCENT(90),    0, 0 },
+    { BENCHMARK_PWM_SET_DUTY,   TCD_CLKSEL_OSCHF_gc,   20000UL, PWM_DUTY_PERCENT(50),    0, 0 },
+    { BENCHMARK_PWM_SET_DUTY,   TCD_CLKSEL_PLL_gc,     20000UL, PWM_DUTY_PERCENT(50),    0, 0 },
+    { BENCHMARK_CLOCK_UPDATE,   TCD_CLKSEL_OSCHF_gc,       0UL, 0,                       0, 0 },
+    { BENCHMARK_CLOCK_UPDATE,   TCD_CLKSEL_PLL_gc,         0UL, 0,                       0, 0 },
+    { BENCHMARK_CLOCK_READ,     TCD_CLKSEL_OSCHF_gc,       0UL, 0,                       0, 0 },
+    { BENCHMARK_SORT_DIAGNOSIS, TCD_CLKSEL_OSCHF_gc,       0UL, 0x8F,                    0, 0 },
+    { BENCHMARK_SORT_DIAGNOSIS, TCD_CLKSEL_OSCHF_gc,       0UL, 0x73,                    0, 0 },
+    { BENCHMARK_WRITE,          TCD_CLKSEL_OSCHF_gc,       0UL, 0xFD,                    0, 0 },
+    { BENCHMARK_START,          TCD_CLKSEL_OSCHF_gc,   20000UL, PWM_DUTY_PERCENT(30),    0, 0 },
+    { BENCHMARK_STOP,           TCD_CLKSEL_OSCHF_gc,   20000UL, PWM_DUTY_PERCENT(30),    0, 0 },
+    { BENCHMARK_SPI_EXCHANGE,   TCD_CLKSEL_OSCHF_gc,       0UL, RD_DIA,                  0, 0 },
+#ifdef CURRENT_CONTROL
+    { BENCHMARK_CURRENT_STEP,   TCD_CLKSEL_PLL_gc,     20000UL, CURRENT_MA(500),         0, 0 },
+    { BENCHMARK_CURRENT_STEP,   TCD_CLKSEL_PLL_gc,     20000UL, CURRENT_MA(1500),        0, 0 },
+#endif
+    { BENCHMARK_PID_STEP,       TCD_CLKSEL_PLL_gc,     20000UL, 500,                     0, 0 },
+    { BENCHMARK_PID_STEP,       TCD_CLKSEL_PLL_gc,     20000UL, 1500,                    0, 0 }
+};
+
+/**
+ * @brief Global instance of BENCHMARK_SUMMARY structure.
+ */
+BENCHMARK_SUMMARY BENCHMARK_Summary = {
+    .status = BENCHMARK_RUNNING ///< Set to PASS or FAIL when the run is finished.
+};
+
+#endif /* BENCHMARKVAR_H_ */
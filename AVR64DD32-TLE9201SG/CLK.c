@@ -5,12 +5,14 @@
  * @details This file provides functions to configure the system clock using 
  *          internal, external, or crystal oscillators, as well as the PLL. 
  *          Configuration options include frequency, prescaler, and clock output.
+ *          Each function refreshes the cached clock tree (CLOCK_Tree) when done.
  * 
  * @author Saulius
  * @date 2025-01-09
  */
 
 #include "Settings.h"
+#include "CLKVar.h"
 
 /**
  * @brief Initializes the high-frequency crystal oscillator (XOSCHF).
@@ -44,6 +46,8 @@ void CLOCK_XOSCHF_crystal_init() {
     while (CLKCTRL.MCLKSTATUS & CLKCTRL_SOSC_bm) {};
 
     /* Configuration complete; main clock is now running at 16 MHz */
+    CLOCK_Tree.xoschf = CLOCK_XOSCHF_CRYSTAL_FREQ;
+    CLOCK_update();
 }
 
 /**
@@ -74,6 +78,8 @@ void CLOCK_XOSCHF_clock_init() {
     while (CLKCTRL.MCLKSTATUS & CLKCTRL_SOSC_bm) {};
 
     /* Configuration complete; main clock is now running at 32 MHz / 2 = 16 MHz */
+    CLOCK_Tree.xoschf = CLOCK_XOSCHF_EXTCLK_FREQ;
+    CLOCK_update();
 }
 
 /**
@@ -96,6 +102,8 @@ void CLOCK_INHF_clock_init() {
 
     /* Wait for oscillator change to complete */
     while (CLKCTRL.MCLKSTATUS & CLKCTRL_SOSC_bm) {};
+
+    CLOCK_update();
 }
 
 /**
@@ -112,18 +120,21 @@ void PLL_init() {
 
     /* Wait for PLL configuration to complete */
     while (CLKCTRL.MCLKSTATUS & CLKCTRL_PLLS_bm) {};
+
+    CLOCK_update();
 }
 
 /**
- * @brief Reads the current clock frequency.
- * 
- * @details Determines the base clock frequency based on oscillator and prescaler settings. 
- *          The maximum frequency is capped at 48 MHz for PLL configurations.
+ * @brief Decodes the clock registers into the cached clock tree.
  * 
- * @return uint32_t The current clock frequency in Hz.
+ * @details Determines the OSCHF, PLL, main, CPU/peripheral and TCD0 clock frequencies
+ *          from the oscillator, prescaler, PLL and TCD0 clock source settings, plus the
+ *          cycles per microsecond of CLK_PER and the TCD0 clock. Called by every function
+ *          that changes the clock tree; everything else only reads CLOCK_Tree.
+ *          The PLL output is capped at 48 MHz.
  */
-uint32_t CLOCK_read() {
-    uint32_t base_freq = 4000000; ///< Default F_CPU. Adjust if using EXCLK or PLL clock source is EXCLK as well.
+void CLOCK_update() {
+    uint32_t base_freq = 4000000; ///< OSCHF reset frequency.
 
     // Determine the base clock frequency based on OSCHFCTRLA settings
     switch (CLKCTRL.OSCHFCTRLA & CLKCTRL_FRQSEL_gm) {
@@ -136,38 +147,67 @@ uint32_t CLOCK_read() {
         case CLKCTRL_FRQSEL_20M_gc: base_freq = 20000000; break;
         case CLKCTRL_FRQSEL_24M_gc: base_freq = 24000000; break;
     }
-
-    // Adjust base frequency for peripheral clock prescaler
-    if ((TCD0.CTRLA & TCD_CLKSEL_gm) == TCD_CLKSEL_CLKPER_gc) {
-        if (CLKCTRL.MCLKCTRLB & CLKCTRL_PEN_bm) {
-            switch (CLKCTRL.MCLKCTRLB & CLKCTRL_PDIV_gm) {
-                case CLKCTRL_PDIV_2X_gc:  base_freq /= 2; break;
-                case CLKCTRL_PDIV_4X_gc:  base_freq /= 4; break;
-                case CLKCTRL_PDIV_6X_gc:  base_freq /= 6; break;
-                case CLKCTRL_PDIV_8X_gc:  base_freq /= 8; break;
-                case CLKCTRL_PDIV_10X_gc: base_freq /= 10; break;
-                case CLKCTRL_PDIV_12X_gc: base_freq /= 12; break;
-                case CLKCTRL_PDIV_16X_gc: base_freq /= 16; break;
-                case CLKCTRL_PDIV_24X_gc: base_freq /= 24; break;
-                case CLKCTRL_PDIV_32X_gc: base_freq /= 32; break;
-                case CLKCTRL_PDIV_48X_gc: base_freq /= 48; break;
-                case CLKCTRL_PDIV_64X_gc: base_freq /= 64; break;
-            }
-        }
+    CLOCK_Tree.oschf = base_freq;
+
+    // Main clock source
+    switch (CLKCTRL.MCLKCTRLA & CLKCTRL_CLKSEL_gm) {
+        case CLKCTRL_CLKSEL_OSC32K_gc:
+        case CLKCTRL_CLKSEL_XOSC32K_gc: CLOCK_Tree.main = CLOCK_OSC32K_FREQ; break;
+        case CLKCTRL_CLKSEL_EXTCLK_gc:  CLOCK_Tree.main = CLOCK_Tree.xoschf; break;
+        default:                        CLOCK_Tree.main = CLOCK_Tree.oschf; break;
     }
 
-    // Adjust base frequency for PLL
-    if ((TCD0.CTRLA & TCD_CLKSEL_gm) == TCD_CLKSEL_PLL_gc) {
-        if ((CLKCTRL.PLLCTRLA & CLKCTRL_PLLCTRLA) == CLKCTRL_MULFAC_2x_gc) {
-            base_freq *= 2;
-        } else if ((CLKCTRL.PLLCTRLA & CLKCTRL_PLLCTRLA) == CLKCTRL_MULFAC_3x_gc) {
-            base_freq *= 3;
+    // Adjust main clock for the peripheral clock prescaler
+    uint8_t divider = 1;
+    if (CLKCTRL.MCLKCTRLB & CLKCTRL_PEN_bm) {
+        switch (CLKCTRL.MCLKCTRLB & CLKCTRL_PDIV_gm) {
+            case CLKCTRL_PDIV_2X_gc:  divider = 2; break;
+            case CLKCTRL_PDIV_4X_gc:  divider = 4; break;
+            case CLKCTRL_PDIV_6X_gc:  divider = 6; break;
+            case CLKCTRL_PDIV_8X_gc:  divider = 8; break;
+            case CLKCTRL_PDIV_10X_gc: divider = 10; break;
+            case CLKCTRL_PDIV_12X_gc: divider = 12; break;
+            case CLKCTRL_PDIV_16X_gc: divider = 16; break;
+            case CLKCTRL_PDIV_24X_gc: divider = 24; break;
+            case CLKCTRL_PDIV_32X_gc: divider = 32; break;
+            case CLKCTRL_PDIV_48X_gc: divider = 48; break;
+            case CLKCTRL_PDIV_64X_gc: divider = 64; break;
         }
+    }
+    CLOCK_Tree.per = CLOCK_Tree.main / divider;
+    CLOCK_Tree.cpu = CLOCK_Tree.per;
+
+    // PLL output from OSCHF or XOSCHF
+    uint32_t pll_source = (CLKCTRL.PLLCTRLA & CLKCTRL_SOURCE_bm) ? CLOCK_Tree.xoschf : CLOCK_Tree.oschf;
+    switch (CLKCTRL.PLLCTRLA & CLKCTRL_MULFAC_gm) {
+        case CLKCTRL_MULFAC_2x_gc: CLOCK_Tree.pll = pll_source * 2; break;
+        case CLKCTRL_MULFAC_3x_gc: CLOCK_Tree.pll = pll_source * 3; break;
+        default:                   CLOCK_Tree.pll = 0; break;
+    }
+    if (CLOCK_Tree.pll > CLOCK_PLL_MAX_FREQ) {
+        CLOCK_Tree.pll = CLOCK_PLL_MAX_FREQ; ///< Cap at 48 MHz (maximum PLL frequency)
+    }
 
-        if (base_freq > 48000000) {
-            base_freq = 48000000; ///< Cap at 48 MHz (maximum PLL frequency)
-        }
+    // TCD0 input clock
+    switch (TCD0.CTRLA & TCD_CLKSEL_gm) {
+        case TCD_CLKSEL_PLL_gc:    CLOCK_Tree.tcd = CLOCK_Tree.pll; break;
+        case TCD_CLKSEL_EXTCLK_gc: CLOCK_Tree.tcd = CLOCK_Tree.xoschf; break;
+        case TCD_CLKSEL_CLKPER_gc: CLOCK_Tree.tcd = CLOCK_Tree.per; break;
+        default:                   CLOCK_Tree.tcd = CLOCK_Tree.oschf; break;
     }
 
-    return base_freq;
+    // Scale factors for microsecond based timing
+    CLOCK_Tree.per_us = CLOCK_Tree.per / 1000000;
+    CLOCK_Tree.tcd_us = CLOCK_Tree.tcd / 1000000;
+}
+
+/**
+ * @brief Reads the current TCD0 clock frequency.
+ * 
+ * @details Returns the cached value decoded by CLOCK_update(); no registers are read.
+ * 
+ * @return uint32_t The TCD0 input clock frequency in Hz.
+ */
+uint32_t CLOCK_read() {
+    return CLOCK_Tree.tcd;
 }
@@ -0,0 +1,47 @@
+/**
+ * @file CLK.h
+ * @brief Header file for the cached clock tree of the AVR64DD32.
+ *
+ * @details The clock initialization functions decode the clock registers once and
+ *          store the resulting frequencies here, so timing calculations read a
+ *          variable instead of walking the CLKCTRL and TCD0 registers every time.
+ *
+ * @author Saulius
+ * @date 2025-01-09
+ */
+
+#ifndef CLK_H_
+#define CLK_H_
+
+/** @brief Frequency of the crystal used by CLOCK_XOSCHF_crystal_init() (16 MHz). */
+#define CLOCK_XOSCHF_CRYSTAL_FREQ 16000000UL
+
+/** @brief Frequency of the external clock used by CLOCK_XOSCHF_clock_init() (32 MHz). */
+#define CLOCK_XOSCHF_EXTCLK_FREQ 32000000UL
+
+/** @brief Frequency of the 32.768 kHz oscillators. */
+#define CLOCK_OSC32K_FREQ 32768UL
+
+/** @brief Maximum PLL output frequency (48 MHz). */
+#define CLOCK_PLL_MAX_FREQ 48000000UL
+
+/**
+ * @struct CLOCK_DATA
+ * @brief Structure for storing the decoded clock tree.
+ */
+typedef struct {
+    uint32_t oschf;  ///< Internal high-frequency oscillator (OSCHF) in Hz.
+    uint32_t xoschf; ///< External crystal or clock (XOSCHF) in Hz, 0 if not used.
+    uint32_t pll;    ///< PLL output in Hz, 0 if the PLL is off.
+    uint32_t main;   ///< Main clock (CLK_MAIN) in Hz.
+    uint32_t cpu;    ///< CPU clock (CLK_CPU) in Hz.
+    uint32_t per;    ///< Peripheral clock (CLK_PER) in Hz, same as CLK_CPU on AVR DD.
+    uint32_t tcd;    ///< TCD0 input clock in Hz (before the TCD prescalers).
+    uint8_t per_us;  ///< CLK_PER cycles per microsecond.
+    uint8_t tcd_us;  ///< TCD0 input clock cycles per microsecond.
+} CLOCK_DATA;
+
+/** @brief Global variable for storing the decoded clock tree. */
+extern CLOCK_DATA CLOCK_Tree;
+
+#endif /* CLK_H_ */
@@ -0,0 +1,32 @@
+/**
+ * @file CLKVar.h
+ * @brief Initialization of the clock tree global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-09
+ */
+
+#ifndef CLKVAR_H_
+#define CLKVAR_H_
+
+#include "CLK.h" ///< Include the header file for the CLOCK_DATA structure definition.
+
+/**
+ * @brief Global instance of CLOCK_DATA structure.
+ *
+ * @details Starts with the reset clock tree (OSCHF at 4 MHz, no prescaler, PLL off).
+ *          Every clock initialization function refreshes it with CLOCK_update().
+ */
+CLOCK_DATA CLOCK_Tree = {
+    .oschf = 4000000, ///< OSCHF reset frequency.
+    .xoschf = 0,      ///< No external clock.
+    .pll = 0,         ///< PLL off.
+    .main = 4000000,  ///< Main clock from OSCHF.
+    .cpu = 4000000,   ///< No prescaler.
+    .per = 4000000,   ///< No prescaler.
+    .tcd = 4000000,   ///< TCD0 clocked from OSCHF.
+    .per_us = 4,      ///< 4 cycles per microsecond.
+    .tcd_us = 4       ///< 4 cycles per microsecond.
+};
+
+#endif /* CLKVAR_H_ */
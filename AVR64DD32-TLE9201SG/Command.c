@@ -0,0 +1,301 @@
+/**
+ * @file Command.c
+ * @brief Binary command interface on USART1.
+ *
+ * @details The USART1 receive interrupt fills a ring buffer; COMMAND_Task() runs in
+ *          the main loop, takes at most COMMAND_BUDGET bytes from it per pass and
+ *          executes at most one request, so a pass takes bounded time whatever
+ *          arrives on the line. Replies go out through the USART1 transmitter
+ *          between telemetry frames.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+#include "CommandVar.h"
+
+/**
+ * @brief Decodes a COBS frame in place.
+ *
+ * @param frame Encoded frame without the delimiter; receives the decoded bytes.
+ * @param length Encoded length.
+ * @return Decoded length, 0 if the frame is malformed.
+ */
+uint8_t COMMAND_Decode(uint8_t *frame, uint8_t length) {
+    uint8_t in = 0;
+    uint8_t out = 0; // Never passes `in`, so decoding in place is safe
+
+    while (in < length) {
+        uint8_t code = frame[in++];
+        if (!code || in + code - 1 > length) {
+            return 0; // Zero inside a frame or block past the end
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            frame[out++] = frame[in++];
+        }
+        if (code < 0xFF && in < length) {
+            frame[out++] = 0x00;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Executes one request.
+ *
+ * @param request Decoded request without the CRC: command, sequence, arguments.
+ * @param length Request length (at least 2).
+ * @param reply Receives the reply payload (COMMAND_REPLY_MAX bytes).
+ * @return Reply length.
+ */
+uint8_t COMMAND_Execute(const uint8_t *request, uint8_t length, uint8_t *reply) {
+    uint8_t args = length - 2;
+    uint16_t value = 0;
+    uint8_t status = COMMAND_OK;
+    uint8_t size = 3;
+
+    if (args == 1) {
+        value = request[2];
+    } else if (args == 2) {
+        value = request[2] | ((uint16_t)request[3] << 8);
+    }
+
+    switch (request[0]) {
+    case COMMAND_SET_DUTY:
+        if (args != 2) {
+            status = COMMAND_INVALID;
+        } else {
+            TLE9201SG_Set_Duty(value);
+        }
+        break;
+    case COMMAND_SET_FREQ:
+        if (args != 2 || !value) {
+            status = COMMAND_INVALID;
+        } else if (!TLE9201SG_Set_Freq(value)) {
+            status = COMMAND_BUSY;
+        }
+        break;
+    case COMMAND_START:
+        if (args) {
+            status = COMMAND_INVALID;
+        } else {
+            TLE9201SG_START();
+        }
+        break;
+    case COMMAND_STOP:
+        if (args) {
+            status = COMMAND_INVALID;
+        } else {
+            TLE9201SG_STOP();
+        }
+        break;
+    case COMMAND_DIR:
+        if (args != 1 || value > 1) {
+            status = COMMAND_INVALID;
+        } else {
+            TLE9201SG_DIR(value);
+        }
+        break;
+    case COMMAND_MODE:
+        if (args != 1 || value > 1) {
+            status = COMMAND_INVALID;
+        } else if (!TLE9201SG_Set_Mode(value)) {
+            status = COMMAND_BUSY;
+        }
+        break;
+    case COMMAND_READ:
+        if (args) {
+            status = COMMAND_INVALID;
+            break;
+        }
+        reply[size++] = TLE9201SG.mode;
+        reply[size++] = TLE9201SG.revision;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ///< Updated by the SPI0 interrupt
+            reply[size++] = TLE9201SG.diag;
+            reply[size++] = TLE9201SG.control;
+        }
+        reply[size++] = TLE9201SG_Fault_Status();
+        reply[size++] = TLE9201SG_Running() ? 1 : 0;
+        reply[size++] = TLE9201SG.mode ? TLE9201SG.SDIR : GET_BIT(PORTD.OUT, PIN5_bp);
+        reply[size++] = TLE9201SG.pwm_freq & 0xFF;
+        reply[size++] = TLE9201SG.pwm_freq >> 8;
+        reply[size++] = TLE9201SG.duty_cycle & 0xFF;
+        reply[size++] = TLE9201SG.duty_cycle >> 8;
+        break;
+    case COMMAND_TELEMETRY:
+        if (args != 2) {
+            status = COMMAND_INVALID;
+        } else {
+            TELEMETRY_set_rate(value);
+        }
+        break;
+    case COMMAND_HISTORY:
+        if (args != 1) {
+            status = COMMAND_INVALID;
+            break;
+        }
+        {
+            DIAG_ENTRY entry;
+            reply[size++] = DIAG_Log.head;
+            reply[size++] = DIAG_LOG_SIZE;
+            if (!DIAG_Get(value, &entry)) {
+                status = COMMAND_INVALID; // Not written yet or overwritten
+                break;
+            }
+            for (uint8_t i = 0; i < 4; i++) {
+                reply[size++] = entry.ticks >> (8 * i);
+            }
+            reply[size++] = entry.diag;
+            reply[size++] = entry.source;
+        }
+        break;
+    case COMMAND_FAULTS:
+        if (args) {
+            status = COMMAND_INVALID;
+            break;
+        }
+        {
+            uint16_t count[DIAG_CLASSES];
+            DIAG_Counters(count);
+            for (uint8_t i = 0; i < DIAG_CLASSES; i++) {
+                reply[size++] = count[i] & 0xFF;
+                reply[size++] = count[i] >> 8;
+            }
+        }
+        break;
+#ifdef PROFILE
+    case COMMAND_PROFILE:
+        if (args != 1 || (value & 0x7F) >= PROFILE_REGIONS) {
+            status = COMMAND_INVALID;
+            break;
+        }
+        {
+            PROFILE_ENTRY entry;
+            PROFILE_Read(value & 0x7F, &entry, value >> 7);
+            uint16_t field[4] = {
+                entry.min, entry.max, entry.count ? entry.sum / entry.count : 0, entry.count
+            };
+            for (uint8_t i = 0; i < 4; i++) {
+                reply[size++] = field[i] & 0xFF;
+                reply[size++] = field[i] >> 8;
+            }
+        }
+        break;
+#endif
+#ifdef JITTER
+    case COMMAND_JITTER:
+        if (args != 1 || (value & 0x7F) > 2) {
+            status = COMMAND_INVALID;
+            break;
+        }
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ///< Updated every PWM period
+            if (!(value & 0x7F)) {
+                uint32_t count = JITTER_Hist.count;
+                uint16_t field[3] = { JITTER_Hist.nominal, JITTER_Hist.min, JITTER_Hist.max };
+                for (uint8_t i = 0; i < 4; i++) {
+                    reply[size++] = count >> (8 * i);
+                }
+                for (uint8_t i = 0; i < 3; i++) {
+                    reply[size++] = field[i] & 0xFF;
+                    reply[size++] = field[i] >> 8;
+                }
+            } else {
+                for (uint8_t i = 0; i < JITTER_BUCKETS; i++) {
+                    uint16_t bucket = ((value & 0x7F) == 1) ? JITTER_Hist.period[i] : JITTER_Hist.jitter[i];
+                    reply[size++] = bucket & 0xFF;
+                    reply[size++] = bucket >> 8;
+                }
+            }
+        }
+        if (value & 0x80) {
+            JITTER_Reset();
+        }
+        break;
+#endif
+    default:
+        status = COMMAND_UNKNOWN;
+        break;
+    }
+
+    reply[0] = request[0] | COMMAND_REPLY;
+    reply[1] = request[1]; // Sequence, matches the reply to the request
+    reply[2] = status;
+    return size;
+}
+
+/**
+ * @brief Checks and executes the received request and encodes the reply.
+ */
+void COMMAND_Process() {
+    uint8_t *frame = COMMAND.frame;
+    uint8_t length = COMMAND_Decode(frame, COMMAND.length);
+
+    if (length < 4 ||
+        TELEMETRY_CRC(frame, length - 2) != (frame[length - 2] | ((uint16_t)frame[length - 1] << 8))) {
+        COMMAND.errors++; // No reply, the sequence number cannot be trusted
+        return;
+    }
+
+    uint8_t block[COMMAND_REPLY_MAX + 2];
+    uint8_t size = COMMAND_Execute(frame, length - 2, block);
+    uint16_t crc = TELEMETRY_CRC(block, size);
+    block[size++] = crc & 0xFF;
+    block[size++] = crc >> 8;
+    COMMAND.reply_length = TELEMETRY_Encode(block, size, COMMAND.reply);
+}
+
+/**
+ * @brief Parses received commands and sends the replies (main loop).
+ *
+ * @details Takes at most COMMAND_BUDGET bytes out of the receive buffer and runs at
+ *          most one request per call. A complete request waits in `frame` while the
+ *          previous reply is still being sent; the receive buffer keeps filling in
+ *          the meantime. Never blocks.
+ */
+void COMMAND_Task() {
+    PROFILE_BEGIN(PROFILE_COMMAND_TASK);
+    if (USART1_Rx.overflow) { // Bytes were lost, the frame being received is broken
+        USART1_Rx.overflow = 0;
+        if (!COMMAND.complete) {
+            COMMAND.discard = 1;
+            COMMAND.errors++;
+        }
+    }
+
+    for (uint8_t n = 0; n < COMMAND_BUDGET && !COMMAND.complete; n++) {
+        uint8_t byte;
+        if (!USART1_Read(&byte)) {
+            break;
+        }
+        if (!byte) { // Delimiter
+            if (COMMAND.discard) {
+                COMMAND.discard = 0;
+                COMMAND.length = 0;
+            } else if (COMMAND.length) {
+                COMMAND.complete = 1;
+            }
+        } else if (!COMMAND.discard) {
+            if (COMMAND.length < COMMAND_FRAME_SIZE) {
+                COMMAND.frame[COMMAND.length++] = byte;
+            } else {
+                COMMAND.discard = 1; // Too long for any request
+                COMMAND.errors++;
+            }
+        }
+    }
+
+    if (COMMAND.sending && !USART1_Busy()) {
+        COMMAND.sending = 0; // Reply buffer free again
+    }
+    if (COMMAND.complete && !COMMAND.reply_length && !COMMAND.sending) {
+        COMMAND_Process();
+        COMMAND.complete = 0;
+        COMMAND.length = 0;
+    }
+    if (COMMAND.reply_length && USART1_Send(COMMAND.reply, COMMAND.reply_length)) {
+        COMMAND.reply_length = 0;
+        COMMAND.sending = 1;
+    }
+    PROFILE_END(PROFILE_COMMAND_TASK);
+}
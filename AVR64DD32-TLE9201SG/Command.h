@@ -0,0 +1,97 @@
+/**
+ * @file Command.h
+ * @brief Header file for the binary command interface on USART1.
+ *
+ * @details Requests use the telemetry framing: the payload is followed by its
+ *          CRC-16/CCITT-FALSE (little endian), COBS encoded and terminated by 0x00.
+ *          A request is `command, sequence, arguments...`; the reply is
+ *          `command | COMMAND_REPLY, sequence, status, data...`. Multi-byte fields
+ *          are little endian. Frames with a bad CRC are dropped without a reply.
+ *          Tools/command.py is the host client.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+/** @brief Sets the duty cycle; argument u16, fraction of 65536. */
+#define COMMAND_SET_DUTY 0x10
+
+/** @brief Sets the PWM frequency; argument u16 in Hz. */
+#define COMMAND_SET_FREQ 0x11
+
+/** @brief Starts the outputs (ramps up to the duty cycle). */
+#define COMMAND_START 0x12
+
+/** @brief Stops the outputs (ramps down). */
+#define COMMAND_STOP 0x13
+
+/** @brief Sets the direction; argument u8, 0 or 1. */
+#define COMMAND_DIR 0x14
+
+/** @brief Switches the control mode while stopped; argument u8, TLE9201SG_MODE_SPI or TLE9201SG_MODE_PWMDIR. */
+#define COMMAND_MODE 0x15
+
+/** @brief Reads the registers; reply data mode, revision, diag, control, fault, running, direction, pwm_freq u16, duty_cycle u16. */
+#define COMMAND_READ 0x16
+
+/** @brief Sets the telemetry rate; argument u16 in frames per second, 0 stops the stream. */
+#define COMMAND_TELEMETRY 0x17
+
+/** @brief Reads a diagnosis history entry; argument u8 entry number; reply data head, DIAG_LOG_SIZE, then ticks u32, diag and source if the entry is kept (status COMMAND_INVALID otherwise). */
+#define COMMAND_HISTORY 0x18
+
+/** @brief Reads the fault counters; reply data DIAG_CLASSES u16 counters (DIA, CL, TV, OT, TCD). */
+#define COMMAND_FAULTS 0x19
+
+/** @brief Reads a profiled region (PROFILE builds only); argument u8 region, bit 7 set clears it after reading; reply data min, max, mean and count, u16 each. */
+#define COMMAND_PROFILE 0x1A
+
+/** @brief Reads the period histograms (JITTER builds only); argument u8: 0 summary (count u32, nominal, min, max u16), 1 period histogram, 2 jitter histogram (JITTER_BUCKETS u16); bit 7 set clears them after reading. */
+#define COMMAND_JITTER 0x1B
+
+/** @brief Flag set in the first byte of a reply. */
+#define COMMAND_REPLY 0x80
+
+/** @brief Status: done. */
+#define COMMAND_OK 0
+
+/** @brief Status: cannot be done in the current state (e.g. running), try again later. */
+#define COMMAND_BUSY 1
+
+/** @brief Status: wrong argument length or value. */
+#define COMMAND_INVALID 2
+
+/** @brief Status: unknown command. */
+#define COMMAND_UNKNOWN 3
+
+/** @brief Largest encoded request without the delimiter; longer frames are dropped. */
+#define COMMAND_FRAME_SIZE 16
+
+/** @brief Largest reply payload (a COMMAND_JITTER histogram). */
+#define COMMAND_REPLY_MAX (3 + 2 * JITTER_BUCKETS)
+
+/** @brief Received bytes parsed per main loop pass at most. */
+#define COMMAND_BUDGET 16
+
+/**
+ * @struct COMMAND_DATA
+ * @brief Structure for storing the command parser state and the reply frame.
+ */
+typedef struct {
+    uint8_t frame[COMMAND_FRAME_SIZE]; ///< Encoded request being received.
+    uint8_t length;   ///< Bytes in `frame`.
+    uint8_t complete; ///< 1 when `frame` holds a whole request waiting for the reply buffer.
+    uint8_t discard;  ///< 1 while skipping the rest of a broken frame.
+    uint8_t reply[COMMAND_REPLY_MAX + 2 + 1 + 1]; ///< Encoded reply.
+    uint8_t reply_length; ///< Encoded reply length, 0 if none is waiting.
+    uint8_t sending;  ///< 1 while the reply may still be on the wire.
+    uint8_t errors;   ///< Dropped frames (overflow, too long, malformed or bad CRC).
+} COMMAND_DATA;
+
+/** @brief Global variable for storing the command parser state. */
+extern COMMAND_DATA COMMAND;
+
+#endif /* COMMAND_H_ */
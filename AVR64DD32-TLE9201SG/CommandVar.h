@@ -0,0 +1,26 @@
+/**
+ * @file CommandVar.h
+ * @brief Initialization of the command parser global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef COMMANDVAR_H_
+#define COMMANDVAR_H_
+
+#include "Command.h" ///< Include the header file for the COMMAND_DATA structure definition.
+
+/**
+ * @brief Global instance of COMMAND_DATA structure.
+ */
+COMMAND_DATA COMMAND = {
+    .length = 0,       ///< Nothing received.
+    .complete = 0,     ///< No request waiting.
+    .discard = 0,      ///< In sync with the frames.
+    .reply_length = 0, ///< No reply waiting.
+    .sending = 0,      ///< Reply buffer free.
+    .errors = 0        ///< No frames dropped yet.
+};
+
+#endif /* COMMANDVAR_H_ */
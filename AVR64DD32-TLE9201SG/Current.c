@@ -0,0 +1,165 @@
+/**
+ * @file Current.c
+ * @brief Motor current PI regulator synchronized with the TCD0 PWM period.
+ *
+ * @details Compiled in only when CURRENT_CONTROL is defined (see Settings.h).
+ *          TCD0 generates a programmable event delayed from the CMPBCLR match so it
+ *          falls in the middle of the output pulse. EVSYS channel 1 routes it to the
+ *          ADC0 start input, and the ADC result interrupt runs the PI regulator and
+ *          stages the new duty for the next period: one sample, calculation and update
+ *          per PWM period. The duty ramp (Ramp.c) only sets the highest duty allowed,
+ *          so soft start, braking and reversal still work in current mode.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+
+#ifdef CURRENT_CONTROL
+
+#include "CurrentVar.h"
+
+/**
+ * @brief Places the ADC trigger in the middle of the output pulse.
+ *
+ * @details Double slope: the pulse is centred on the counter bottom, half a period
+ *          (CMPBCLR + 1 counts) after the CMPBCLR match at the top. One ramp: the pulse
+ *          starts at the cycle boundary, so the middle is half the on-time later.
+ *          The delay counter has 8 bits and a prescaler of up to 8; longer delays are
+ *          clamped (periods above 2040 counts in double slope).
+ */
+void CURRENT_Delay() {
+    uint16_t delay = (TCD0_PWM.wgmode == TCD_WGMODE_DS_gc) ? TCD0_PWM.period + 1 : (TCD0_PWM.count + 1) / 2;
+    uint8_t presc = 0;
+
+    while ((delay >> presc) > 0xFF && presc < 3) {
+        presc++;
+    }
+    if ((delay >> presc) > 0xFF) {
+        delay = 0xFF << presc; // Longest delay the counter can do
+    }
+    TCD0.DLYVAL = delay >> presc;
+    TCD0.DLYCTRL = (presc << TCD_DLYPRESC_gp) | ///< Delay prescaler 1, 2, 4 or 8
+                   TCD_DLYTRIG_CMPBCLR_gc | ///< Start the delay at the CMPBCLR match
+                   TCD_DLYSEL_EVENT_gc; ///< Delayed programmable event output
+}
+
+/**
+ * @brief Initializes ADC0 and the TCD0 to ADC0 event path for current sampling.
+ *
+ * @details Call after PWM_init() so the trigger delay matches the PWM period.
+ *          The regulator stays disabled until CURRENT_ON().
+ */
+void CURRENT_init() {
+    PORTD.PIN2CTRL = PORT_ISC_INPUT_DISABLE_gc; ///< Analog input, no digital buffer
+
+    VREF.ADC0REF = VREF_REFSEL_VDD_gc; ///< VDD as reference (CURRENT_VREF_MV)
+    ADC0.CTRLC = ADC_PRESC_DIV16_gc; ///< 1.5 MHz ADC clock at 24 MHz, conversion well within a 20 kHz period
+    ADC0.MUXPOS = CURRENT_MUXPOS; ///< Shunt amplifier output
+    ADC0.EVCTRL = ADC_STARTEI_bm; ///< Conversion started by the event
+    ADC0.INTFLAGS = ADC_RESRDY_bm;
+    ADC0.INTCTRL = ADC_RESRDY_bm; ///< Regulate on every result
+    ADC0.CTRLA = ADC_RESSEL_12BIT_gc | ///< 12-bit result
+                 ADC_ENABLE_bm; ///< Enable ADC0
+
+    EVSYS.CHANNEL1 = EVSYS_CHANNEL1_TCD0_PROGEV_gc; ///< TCD0 delayed event
+    EVSYS.USERADC0START = EVSYS_USER_CHANNEL1_gc; ///< Starts ADC0
+    CURRENT_Delay();
+}
+
+/**
+ * @brief Sets the target current.
+ *
+ * @param setpoint Current in ADC counts (see CURRENT_MA()).
+ */
+void CURRENT_set(uint16_t setpoint) {
+    CURRENT_Loop.setpoint = setpoint;
+}
+
+/**
+ * @brief Sets the PI gains.
+ *
+ * @param kp Proportional gain, duty steps per ADC count (Q4).
+ * @param ki Integral gain, duty steps per ADC count and period (Q4).
+ */
+void CURRENT_set_gains(int16_t kp, int16_t ki) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        CURRENT_Loop.kp = kp;
+        CURRENT_Loop.ki = ki;
+    }
+}
+
+/**
+ * @brief Hands the duty over to the current regulator.
+ *
+ * @details The integrator starts from the duty applied so far, so switching over
+ *          does not step the output.
+ */
+void CURRENT_ON() {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        CURRENT_Loop.limit = RAMP.duty;
+        CURRENT_Loop.integral = RAMP.duty;
+        CURRENT_Loop.duty = RAMP.duty;
+        CURRENT_Loop.enabled = 1;
+    }
+}
+
+/**
+ * @brief Returns the duty to the open-loop ramp.
+ */
+void CURRENT_OFF() {
+    CURRENT_Loop.enabled = 0;
+    TLE9201SG_Apply_Duty(RAMP.duty);
+}
+
+/**
+ * @brief Runs one PI step on a current sample.
+ *
+ * @details Integer only. The integrator is held between zero and `limit`
+ *          (anti-windup), and so is the output.
+ *
+ * @param measured Current sample in ADC counts.
+ * @return New duty cycle as a fraction of 65536.
+ */
+uint16_t CURRENT_Regulate(uint16_t measured) {
+    int16_t error = (int16_t)CURRENT_Loop.setpoint - (int16_t)measured;
+    int32_t limit = CURRENT_Loop.limit;
+
+    int32_t integral = CURRENT_Loop.integral + (((int32_t)CURRENT_Loop.ki * error) >> CURRENT_GAIN_SHIFT);
+    if (integral < 0) {
+        integral = 0;
+    } else if (integral > limit) {
+        integral = limit;
+    }
+    CURRENT_Loop.integral = integral;
+
+    int32_t output = integral + (((int32_t)CURRENT_Loop.kp * error) >> CURRENT_GAIN_SHIFT);
+    if (output < 0) {
+        output = 0;
+    } else if (output > limit) {
+        output = limit;
+    }
+    CURRENT_Loop.measured = measured;
+    CURRENT_Loop.duty = output;
+    return output;
+}
+
+/**
+ * @brief ADC0 result interrupt: one current sample per PWM period.
+ *
+ * @details The new duty is staged with PWM_set_duty() and used from the next TCD
+ *          cycle. The trigger delay follows period and duty changes.
+ */
+ISR(ADC0_RESRDY_vect) {
+    uint16_t measured = ADC0.RES; ///< Reading the result clears the flag
+
+    if (CURRENT_Loop.enabled) {
+        PWM_set_duty(CURRENT_Regulate(measured));
+        CURRENT_Delay();
+    } else {
+        CURRENT_Loop.measured = measured;
+    }
+}
+
+#endif /* CURRENT_CONTROL */
@@ -0,0 +1,57 @@
+/**
+ * @file Current.h
+ * @brief Header file for the motor current PI regulator (PWM/DIR mode).
+ *
+ * @details The shunt voltage on PD2 (AIN2) is converted by ADC0 once per PWM period.
+ *          TCD0 starts the conversion through EVSYS in the middle of the output pulse,
+ *          where the sampled current equals the average current, and the PI regulator
+ *          sets the duty of the next period from the ADC interrupt.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef CURRENT_H_
+#define CURRENT_H_
+
+/** @brief ADC input of the current shunt amplifier (PD2). */
+#define CURRENT_MUXPOS ADC_MUXPOS_AIN2_gc
+
+/** @brief Shunt resistance in milliohm. */
+#define CURRENT_SHUNT_MOHM 50
+
+/** @brief Gain of the shunt amplifier. */
+#define CURRENT_AMP_GAIN 20
+
+/** @brief ADC reference voltage in millivolt (VDD). */
+#define CURRENT_VREF_MV 3300
+
+/**
+ * @brief Converts a current in milliampere to ADC counts (12-bit).
+ * @param ma Current in mA.
+ * @return Current as ADC counts.
+ */
+#define CURRENT_MA(ma) ((uint16_t)(((uint32_t)(ma) * CURRENT_SHUNT_MOHM * CURRENT_AMP_GAIN * 4096UL) / (1000UL * CURRENT_VREF_MV)))
+
+/** @brief Fractional bits of the PI gains (gains are duty steps per ADC count, Q4). */
+#define CURRENT_GAIN_SHIFT 4
+
+/**
+ * @struct CURRENT_DATA
+ * @brief Structure for storing the current regulator state and tuning.
+ */
+typedef struct {
+    uint16_t setpoint; ///< Target current in ADC counts (see CURRENT_MA()).
+    uint16_t measured; ///< Last current sample in ADC counts.
+    int16_t kp;        ///< Proportional gain, duty steps per ADC count (Q4).
+    int16_t ki;        ///< Integral gain, duty steps per ADC count and period (Q4).
+    int32_t integral;  ///< Integrator in duty steps, held within 0 and `limit`.
+    uint16_t limit;    ///< Highest duty the regulator may apply, follows the duty ramp.
+    uint16_t duty;     ///< Duty applied by the regulator, as a fraction of 65536.
+    uint8_t enabled;   ///< 1 while the regulator drives the duty.
+} CURRENT_DATA;
+
+/** @brief Global variable for storing the current regulator state. */
+extern volatile CURRENT_DATA CURRENT_Loop;
+
+#endif /* CURRENT_H_ */
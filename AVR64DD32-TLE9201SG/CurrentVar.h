@@ -0,0 +1,30 @@
+/**
+ * @file CurrentVar.h
+ * @brief Initialization of the motor current regulator global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef CURRENTVAR_H_
+#define CURRENTVAR_H_
+
+#include "Current.h" ///< Include the header file for the CURRENT_DATA structure definition.
+
+/**
+ * @brief Global instance of CURRENT_DATA structure.
+ *
+ * @details Starts disabled with conservative gains; tune them for the load with
+ *          CURRENT_set_gains().
+ */
+volatile CURRENT_DATA CURRENT_Loop = {
+    .setpoint = CURRENT_MA(1000), ///< 1 A.
+    .kp = 4 << CURRENT_GAIN_SHIFT, ///< 4 duty steps per ADC count.
+    .ki = 1 << CURRENT_GAIN_SHIFT, ///< 1 duty step per ADC count and period.
+    .integral = 0,                ///< Outputs off.
+    .limit = 0,                   ///< Outputs off.
+    .duty = 0,                    ///< Outputs off.
+    .enabled = 0                  ///< Open-loop duty until CURRENT_ON().
+};
+
+#endif /* CURRENTVAR_H_ */
@@ -0,0 +1,129 @@
+/**
+ * @file DiagLog.c
+ * @brief Diagnosis history and fault counters of the TLE9201SG.
+ *
+ * @details DIAG_Record() runs from the SPI0 interrupt only when the diagnosis byte
+ *          changes, so a steady state costs nothing per PWM period. DIAG_Record_Latch()
+ *          runs when the TCD0 fault latch trips or recovers.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+#include "DiagLogVar.h"
+
+/**
+ * @brief Starts recording diagnosis changes.
+ *
+ * @details Installs DIAG_Record() as the TLE9201SG diagnosis hook and
+ *          DIAG_Record_Latch() as its fault latch hook.
+ */
+void DIAG_init() {
+    TLE9201SG_set_hook(DIAG_Record);
+    TLE9201SG_set_latch_hook(DIAG_Record_Latch);
+}
+
+/**
+ * @brief Counts one fault onset, saturating.
+ *
+ * @param cls Fault class (DIAG_CLASS_DIA ...).
+ */
+void DIAG_Count(uint8_t cls) {
+    if (DIAG_Log.count[cls] != 0xFFFF) {
+        DIAG_Log.count[cls]++;
+    }
+}
+
+/**
+ * @brief Records a diagnosis change (TLE9201SG diagnosis hook, SPI0 interrupt).
+ *
+ * @param previous The previous diagnosis byte.
+ * @param diag The new diagnosis byte.
+ */
+void DIAG_Record(uint8_t previous, uint8_t diag) {
+    uint8_t head = DIAG_Log.head;
+    volatile DIAG_ENTRY *entry = &DIAG_Log.entry[head & (DIAG_LOG_SIZE - 1)];
+
+    entry->ticks = RTC_Ticks;
+    entry->diag = diag;
+    entry->source = DIAG_SOURCE_SPI;
+
+    uint8_t dia = GET_BITS(diag, TLE9201SG_DIA_gm);
+    if (dia != TLE9201SG_DIA_OK && dia != GET_BITS(previous, TLE9201SG_DIA_gm)) {
+        DIAG_Count(DIAG_CLASS_DIA);
+    }
+    uint8_t onset = diag & ~previous; // Status bits that just came on
+    if (onset & TLE9201SG_CL_bm) {
+        DIAG_Count(DIAG_CLASS_CL);
+    }
+    if (onset & TLE9201SG_TV_bm) {
+        DIAG_Count(DIAG_CLASS_TV);
+    }
+    if (onset & TLE9201SG_OT_bm) {
+        DIAG_Count(DIAG_CLASS_OT);
+    }
+
+    DIAG_Log.head = head + 1; // Publish the entry and the counters
+}
+
+/**
+ * @brief Records a TCD0 fault latch change (TLE9201SG latch hook).
+ *
+ * @details Runs from the TCD0 fault interrupt when the latch trips and from the
+ *          main loop when TLE9201SG_Fault_Recover() clears it, so the entry is
+ *          written with interrupts disabled.
+ *
+ * @param latched 1 when the latch tripped, 0 when it recovered.
+ */
+void DIAG_Record_Latch(uint8_t latched) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        uint8_t head = DIAG_Log.head;
+        volatile DIAG_ENTRY *entry = &DIAG_Log.entry[head & (DIAG_LOG_SIZE - 1)];
+        entry->ticks = RTC_Ticks;
+        entry->diag = latched;
+        entry->source = DIAG_SOURCE_TCD;
+        if (latched) {
+            DIAG_Count(DIAG_CLASS_TCD);
+        }
+        DIAG_Log.head = head + 1; // Publish the entry and the counters
+    }
+}
+
+/**
+ * @brief Copies one history entry (lock-free).
+ *
+ * @param number Entry number; the last DIAG_LOG_SIZE entries before `DIAG_Log.head`
+ *               are kept.
+ * @param entry Receives the entry.
+ * @return 1 if copied, 0 if the entry was not written yet or is overwritten.
+ */
+uint8_t DIAG_Get(uint8_t number, DIAG_ENTRY *entry) {
+    uint8_t age = DIAG_Log.head - number;
+    if (!age || age > DIAG_LOG_SIZE) {
+        return 0;
+    }
+    volatile DIAG_ENTRY *slot = &DIAG_Log.entry[number & (DIAG_LOG_SIZE - 1)];
+    entry->ticks = slot->ticks;
+    entry->diag = slot->diag;
+    entry->source = slot->source;
+    age = DIAG_Log.head - number; // Overwritten meanwhile if the writer got round to it
+    return age <= DIAG_LOG_SIZE;
+}
+
+/**
+ * @brief Copies the fault counters (lock-free).
+ *
+ * @param count Receives DIAG_CLASSES counters.
+ * @return Entry number `DIAG_Log.head` the counters belong to.
+ */
+uint8_t DIAG_Counters(uint16_t *count) {
+    uint8_t head;
+    do {
+        head = DIAG_Log.head;
+        for (uint8_t i = 0; i < DIAG_CLASSES; i++) {
+            count[i] = DIAG_Log.count[i];
+        }
+    } while (head != DIAG_Log.head);
+    return head;
+}
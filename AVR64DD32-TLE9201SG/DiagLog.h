@@ -0,0 +1,71 @@
+/**
+ * @file DiagLog.h
+ * @brief Header file for the TLE9201SG diagnosis history.
+ *
+ * @details Every change of the diagnosis byte is stored with its RTC_Ticks time in a
+ *          ring buffer, and the onset of each fault class is counted, so faults that
+ *          clear again before the main loop looks are not lost. In PWM/DIR mode the
+ *          diagnosis is not read; the TCD0 fault latch is logged instead, as entries
+ *          of source DIAG_SOURCE_TCD. The SPI0 interrupt (diagnosis hook), the TCD0
+ *          fault interrupt and the fault recovery (latch hook) write; readers in the
+ *          main loop use DIAG_Get() and DIAG_Counters(), which detect a concurrent
+ *          write instead of locking.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef DIAGLOG_H_
+#define DIAGLOG_H_
+
+/** @brief Number of diagnosis changes kept (power of two, at most 128). */
+#define DIAG_LOG_SIZE 16
+
+/** @brief Fault class: DIA reports an error (counted per new error code). */
+#define DIAG_CLASS_DIA 0
+
+/** @brief Fault class: current limit (CL). */
+#define DIAG_CLASS_CL 1
+
+/** @brief Fault class: thermal warning (TV). */
+#define DIAG_CLASS_TV 2
+
+/** @brief Fault class: over-temperature (OT). */
+#define DIAG_CLASS_OT 3
+
+/** @brief Fault class: TCD0 fault input tripped (PWM/DIR mode). */
+#define DIAG_CLASS_TCD 4
+
+/** @brief Number of fault classes. */
+#define DIAG_CLASSES 5
+
+/** @brief Entry source: diagnosis byte received over SPI. */
+#define DIAG_SOURCE_SPI 0
+
+/** @brief Entry source: TCD0 fault latch, `diag` is 1 when it tripped and 0 when it recovered. */
+#define DIAG_SOURCE_TCD 1
+
+/**
+ * @struct DIAG_ENTRY
+ * @brief One recorded diagnosis change.
+ */
+typedef struct {
+    uint32_t ticks; ///< RTC_Ticks when the new byte was received.
+    uint8_t diag;   ///< New diagnosis byte (DIAG_SOURCE_TCD: new latch state).
+    uint8_t source; ///< DIAG_SOURCE_SPI or DIAG_SOURCE_TCD.
+} DIAG_ENTRY;
+
+/**
+ * @struct DIAG_LOG
+ * @brief Structure for storing the diagnosis history and fault counters.
+ */
+typedef struct {
+    DIAG_ENTRY entry[DIAG_LOG_SIZE]; ///< Ring buffer, entry n is at `n % DIAG_LOG_SIZE`.
+    uint16_t count[DIAG_CLASSES];    ///< Onsets per fault class (saturate at 0xFFFF).
+    uint8_t head;                    ///< Number of the next entry (wraps), written last.
+} DIAG_LOG;
+
+/** @brief Global variable for storing the diagnosis history. */
+extern volatile DIAG_LOG DIAG_Log;
+
+#endif /* DIAGLOG_H_ */
@@ -0,0 +1,22 @@
+/**
+ * @file DiagLogVar.h
+ * @brief Initialization of the diagnosis history global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef DIAGLOGVAR_H_
+#define DIAGLOGVAR_H_
+
+#include "DiagLog.h" ///< Include the header file for the DIAG_LOG structure definition.
+
+/**
+ * @brief Global instance of DIAG_LOG structure.
+ */
+volatile DIAG_LOG DIAG_Log = {
+    .count = { 0 }, ///< No faults counted.
+    .head = 0       ///< History is empty.
+};
+
+#endif /* DIAGLOGVAR_H_ */
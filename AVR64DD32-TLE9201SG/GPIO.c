@@ -4,12 +4,14 @@
  *
  * @details Configures GPIO pins for SPI communication, PWM control, and input handling 
  *          with pull-up resistors. Initializes directions and states for each pin.
+ *          Input edges are debounced and delivered to the main loop as events.
  * 
  * @author Saulius
  * @date 2025-01-10
  */
 
 #include "Settings.h"
+#include "GPIOVar.h"
 
 /**
  * @brief Initializes GPIO pins for various functionalities.
@@ -18,7 +20,8 @@
  * - Configures PORTA for SPI communication: MOSI, SCK, SS as output; MISO as input.
  * - Stops the SPI0 module.
  * - Configures PORTD for motor control: PWM, DIR, DIS as output.
- * - Configures PORTF for input buttons with pull-up resistors: START/STOP, DIR.
+ * - Configures PORTF for input buttons with pull-up resistors and both-edge interrupts: START/STOP, DIR.
+ * - Queues the initial input state as the first event.
  */
 void GPIO_init() {
     /* Configure SPI pins on PORTA */
@@ -30,6 +33,75 @@ void GPIO_init() {
 
     /* Configure input buttons on PORTF */
     PORTF.DIRCLR = PIN5_bm | PIN6_bm;           // Set START/STOP (PF5), DIR (PF6) as inputs
-    PORTF.PIN5CTRL = PORT_PULLUPEN_bm;          // Enable pull-up resistor for START/STOP (PF5)
-    PORTF.PIN6CTRL = PORT_PULLUPEN_bm;          // Enable pull-up resistor for DIR (PF6)
+    PORTF.PIN5CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc; // Enable pull-up resistor and edge interrupt for START/STOP (PF5)
+    PORTF.PIN6CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc; // Enable pull-up resistor and edge interrupt for DIR (PF6)
+
+    /* Let the first debounce pass report the power-up state */
+    GPIO_Input.state = ~PORTF.IN & GPIO_INPUT_gm;
+    GPIO_Input.debounce = GPIO_DEBOUNCE_TICKS;
+}
+
+/**
+ * @brief PORTF pin change interrupt.
+ *
+ * @details Any edge on PF5/PF6 restarts the debounce delay; bouncing contacts keep
+ *          pushing it out until the inputs settle.
+ */
+ISR(PORTF_PORT_vect) {
+    PORTF.INTFLAGS = GPIO_INPUT_gm;
+    GPIO_Input.debounce = GPIO_DEBOUNCE_TICKS;
+}
+
+/**
+ * @brief Samples the inputs once the debounce delay expires.
+ *
+ * @details Called from the RTC periodic interrupt. Queues the new input state if it
+ *          differs from the last debounced one; the event is dropped if the queue is full.
+ */
+void GPIO_Debounce() {
+    if (GPIO_Input.debounce && !--GPIO_Input.debounce) {
+        uint8_t state = PORTF.IN & GPIO_INPUT_gm;
+        if (state != GPIO_Input.state) {
+            uint8_t head = GPIO_Input.head;
+            uint8_t next = (head + 1) & (GPIO_EVENT_QUEUE_SIZE - 1);
+            GPIO_Input.state = state;
+            if (next != GPIO_Input.tail) {
+                GPIO_Input.event[head] = state;
+                GPIO_Input.head = next;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Takes the oldest input event from the queue.
+ *
+ * @param state Receives the debounced PORTF input state (GPIO_INPUT_gm bits, low = pressed).
+ * @return 1 if an event was returned, 0 if the queue is empty.
+ */
+uint8_t GPIO_Event_Get(uint8_t *state) {
+    uint8_t tail = GPIO_Input.tail;
+    if (tail == GPIO_Input.head) {
+        return 0;
+    }
+    *state = GPIO_Input.event[tail];
+    GPIO_Input.tail = (tail + 1) & (GPIO_EVENT_QUEUE_SIZE - 1);
+    return 1;
+}
+
+/**
+ * @brief Puts the CPU into idle sleep until an interrupt, unless an event is queued.
+ *
+ * @details Timers, SPI and the RTC keep running in idle sleep. Interrupts are
+ *          disabled around the queue check so a wake-up cannot be missed.
+ */
+void GPIO_Event_Wait() {
+    cli();
+    if (GPIO_Input.tail == GPIO_Input.head) {
+        sleep_enable();
+        sei(); // Executes the next instruction before any interrupt
+        sleep_cpu();
+        sleep_disable();
+    }
+    sei();
 }
@@ -0,0 +1,40 @@
+/**
+ * @file GPIO.h
+ * @brief Header file for the debounced input event queue.
+ *
+ * @details Edges on the START/STOP (PF5) and DIR (PF6) buttons start a debounce
+ *          delay counted by the RTC periodic interrupt. Once the inputs are stable
+ *          the new state is queued as an event for the main loop.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef GPIO_H_
+#define GPIO_H_
+
+/** @brief Input pins on PORTF handled by the event queue. */
+#define GPIO_INPUT_gm (PIN5_bm | PIN6_bm)
+
+/** @brief Debounce time in RTC ticks (about 20 ms at 1024 Hz). */
+#define GPIO_DEBOUNCE_TICKS 20
+
+/** @brief Number of slots in the input event queue (power of two, one slot stays free). */
+#define GPIO_EVENT_QUEUE_SIZE 8
+
+/**
+ * @struct GPIO_INPUT_DATA
+ * @brief Structure for storing the debounced input state and event queue.
+ */
+typedef struct {
+    uint8_t event[GPIO_EVENT_QUEUE_SIZE]; ///< Queued PORTF input snapshots (GPIO_INPUT_gm bits).
+    uint8_t head;     ///< Index of the next free slot.
+    uint8_t tail;     ///< Index of the oldest event.
+    uint8_t debounce; ///< RTC ticks left until the inputs are sampled, 0 when idle.
+    uint8_t state;    ///< Last debounced input state.
+} GPIO_INPUT_DATA;
+
+/** @brief Global variable for storing the input event queue. */
+extern volatile GPIO_INPUT_DATA GPIO_Input;
+
+#endif /* GPIO_H_ */
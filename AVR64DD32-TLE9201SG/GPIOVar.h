@@ -0,0 +1,26 @@
+/**
+ * @file GPIOVar.h
+ * @brief Initialization of the input event queue global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef GPIOVAR_H_
+#define GPIOVAR_H_
+
+#include "GPIO.h" ///< Include the header file for the GPIO_INPUT_DATA structure definition.
+
+/**
+ * @brief Global instance of GPIO_INPUT_DATA structure.
+ *
+ * @details The queue starts empty; GPIO_init() queues the initial input state.
+ */
+volatile GPIO_INPUT_DATA GPIO_Input = {
+    .head = 0,     ///< Queue is empty.
+    .tail = 0,     ///< Queue is empty.
+    .debounce = 0, ///< No edge seen yet.
+    .state = GPIO_INPUT_gm ///< Buttons released (pull-ups).
+};
+
+#endif /* GPIOVAR_H_ */
@@ -0,0 +1,102 @@
+/**
+ * @file Jitter.c
+ * @brief PWM period and jitter histograms.
+ *
+ * @details Compiled in only when JITTER is defined (see Settings.h).
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+
+#ifdef JITTER
+
+#include "JitterVar.h"
+
+/**
+ * @brief Starts the TCB1 cycle counter and clears the histograms.
+ */
+void JITTER_init() {
+    TCB1_Cycle_init();
+    JITTER_Reset();
+}
+
+/**
+ * @brief Clears the histograms and takes the nominal period from `TLE9201SG.pwm_freq`.
+ *
+ * @details Call it after a frequency change; the next mark starts a new measurement.
+ */
+void JITTER_Reset() {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        for (uint8_t i = 0; i < JITTER_BUCKETS; i++) {
+            JITTER_Hist.period[i] = 0;
+            JITTER_Hist.jitter[i] = 0;
+        }
+        JITTER_Hist.count = 0;
+        JITTER_Hist.nominal = TLE9201SG.pwm_freq ? CLOCK_Tree.per / TLE9201SG.pwm_freq : 0;
+        JITTER_Hist.min = 0xFFFF;
+        JITTER_Hist.max = 0;
+        JITTER_Hist.last = 0;
+        JITTER_Hist.started = 0;
+    }
+}
+
+/**
+ * @brief Ends the measurement when the PWM stops.
+ *
+ * @details The histograms are kept; the next mark starts over, so the pause is not
+ *          counted as a period.
+ */
+void JITTER_Stop() {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        JITTER_Hist.started = 0;
+        JITTER_Hist.last = 0;
+    }
+}
+
+/**
+ * @brief Marks the start of a PWM period (interrupt context).
+ *
+ * @details The time since the previous mark is one period; it is sorted into both
+ *          histograms. Keep it the first thing the calling interrupt does.
+ */
+void JITTER_Mark() {
+    uint16_t now = TCB1_CYCLES();
+    uint16_t period = now - JITTER_Hist.stamp;
+    JITTER_Hist.stamp = now;
+    if (!JITTER_Hist.started) {
+        JITTER_Hist.started = 1;
+        return;
+    }
+
+    int32_t deviation = ((int32_t)period - JITTER_Hist.nominal) >> JITTER_SHIFT; // Arithmetic shift, rounds down
+    if (deviation < -(JITTER_BUCKETS / 2)) {
+        deviation = -(JITTER_BUCKETS / 2);
+    } else if (deviation > JITTER_BUCKETS / 2 - 1) {
+        deviation = JITTER_BUCKETS / 2 - 1;
+    }
+    uint8_t bucket = deviation + JITTER_BUCKETS / 2;
+    if (JITTER_Hist.period[bucket] != 0xFFFF) {
+        JITTER_Hist.period[bucket]++;
+    }
+
+    if (JITTER_Hist.last) {
+        uint16_t change = (period > JITTER_Hist.last ? period - JITTER_Hist.last : JITTER_Hist.last - period) >> JITTER_SHIFT;
+        bucket = change < JITTER_BUCKETS ? change : JITTER_BUCKETS - 1;
+        if (JITTER_Hist.jitter[bucket] != 0xFFFF) {
+            JITTER_Hist.jitter[bucket]++;
+        }
+    }
+    JITTER_Hist.last = period;
+
+    if (period < JITTER_Hist.min) {
+        JITTER_Hist.min = period;
+    }
+    if (period > JITTER_Hist.max) {
+        JITTER_Hist.max = period;
+    }
+    JITTER_Hist.count++;
+}
+
+#endif /* JITTER */
@@ -0,0 +1,52 @@
+/**
+ * @file Jitter.h
+ * @brief Header file for the PWM period and jitter histograms.
+ *
+ * @details JITTER_Mark() timestamps every PWM period with the free-running TCB1 cycle
+ *          counter: in SPI mode when the frame that sets SPWM has been shifted out
+ *          (the edge the TLE9201SG sees), in PWM/DIR mode at every TCD0 overflow. Each
+ *          period goes into two histograms in SRAM: its deviation from the nominal
+ *          period and its change from the previous period (cycle-to-cycle jitter).
+ *          Compiled in only when JITTER is defined (see Settings.h); read with
+ *          COMMAND_JITTER. Periods must be shorter than 65536 CLK_PER cycles.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef JITTER_H_
+#define JITTER_H_
+
+/** @brief Number of buckets per histogram (even). */
+#define JITTER_BUCKETS 16
+
+/** @brief Bucket width is 2^JITTER_SHIFT CLK_PER cycles (8 cycles, 1/3 us at 24 MHz). */
+#ifndef JITTER_SHIFT
+#define JITTER_SHIFT 3
+#endif
+
+/**
+ * @struct JITTER_DATA
+ * @brief Structure for storing the period and jitter histograms.
+ *
+ * @details `period[i]` counts periods whose deviation from `nominal` falls in bucket
+ *          `i - JITTER_BUCKETS / 2`; `jitter[i]` counts changes from the previous
+ *          period of `i` bucket widths. The outer buckets collect everything beyond.
+ *          Buckets saturate at 0xFFFF.
+ */
+typedef struct {
+    uint16_t period[JITTER_BUCKETS]; ///< Histogram of the period deviation.
+    uint16_t jitter[JITTER_BUCKETS]; ///< Histogram of the period change.
+    uint32_t count;    ///< Periods measured.
+    uint16_t nominal;  ///< Expected period in CLK_PER cycles.
+    uint16_t min;      ///< Shortest period measured.
+    uint16_t max;      ///< Longest period measured.
+    uint16_t stamp;    ///< TCB1 count at the last mark.
+    uint16_t last;     ///< Last period, 0 until one is measured.
+    uint8_t started;   ///< 1 once `stamp` is valid.
+} JITTER_DATA;
+
+/** @brief Global variable for storing the histograms. */
+extern volatile JITTER_DATA JITTER_Hist;
+
+#endif /* JITTER_H_ */
@@ -0,0 +1,28 @@
+/**
+ * @file JitterVar.h
+ * @brief Initialization of the period and jitter histogram global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef JITTERVAR_H_
+#define JITTERVAR_H_
+
+#include "Jitter.h" ///< Include the header file for the JITTER_DATA structure definition.
+
+/**
+ * @brief Global instance of JITTER_DATA structure.
+ *
+ * @details Empty histograms; JITTER_Reset() sets the nominal period.
+ */
+volatile JITTER_DATA JITTER_Hist = {
+    .count = 0,     ///< Nothing measured.
+    .nominal = 0,   ///< Set by JITTER_Reset().
+    .min = 0xFFFF,  ///< Any period is shorter.
+    .max = 0,       ///< Any period is longer.
+    .last = 0,      ///< No previous period.
+    .started = 0    ///< First mark only starts the measurement.
+};
+
+#endif /* JITTERVAR_H_ */
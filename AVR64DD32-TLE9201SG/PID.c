@@ -0,0 +1,137 @@
+/**
+ * @file PID.c
+ * @brief Fixed-point PID speed controller run from the TCA0 control tick.
+ *
+ * @details Every tick the latest speed is taken from the TCB2 measurement and one PID
+ *          step computes the duty, which is applied directly with TLE9201SG_Drive().
+ *          The integrator is clamped between zero and the highest allowed duty
+ *          (anti-windup), the derivative acts on the filtered measurement so setpoint
+ *          steps do not kick the output, and the output saturates at the duty limit set
+ *          by the ramp generator, so soft start, braking and reversal still apply.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+#include "PIDVar.h"
+
+/**
+ * @brief Sets the target speed.
+ *
+ * @param rpm Speed in revolutions per minute.
+ */
+void PID_set(uint16_t rpm) {
+    PID_Speed.setpoint = rpm;
+}
+
+/**
+ * @brief Sets the PID gains (Q8.8).
+ *
+ * @param kp Proportional gain, duty steps per RPM.
+ * @param ki Integral gain, duty steps per RPM and tick.
+ * @param kd Derivative gain, duty steps per RPM change per tick.
+ */
+void PID_set_gains(int16_t kp, int16_t ki, int16_t kd) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        PID_Speed.kp = kp;
+        PID_Speed.ki = ki;
+        PID_Speed.kd = kd;
+    }
+}
+
+/**
+ * @brief Hands the duty over to the speed controller.
+ *
+ * @details The integrator starts from the duty applied so far, so switching over
+ *          does not step the output.
+ */
+void PID_ON() {
+    SPEED_SNAPSHOT speed;
+    SPEED_Read(&speed);
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        PID_Speed.limit = RAMP.duty;
+        PID_Speed.integral = (int32_t)RAMP.duty << PID_GAIN_SHIFT;
+        PID_Speed.slope = 0;
+        PID_Speed.measured = speed.rpm;
+        PID_Speed.duty = RAMP.duty;
+        PID_Speed.enabled = 1;
+    }
+}
+
+/**
+ * @brief Returns the duty to the open-loop ramp.
+ */
+void PID_OFF() {
+    PID_Speed.enabled = 0;
+    TLE9201SG_Apply_Duty(RAMP.duty);
+}
+
+/**
+ * @brief Runs one PID step on a speed sample.
+ *
+ * @param measured Speed in RPM.
+ * @return New duty cycle as a fraction of 65536, within 0 and `limit`.
+ */
+uint16_t PID_Step(uint16_t measured) {
+    int32_t limit = (int32_t)PID_Speed.limit << PID_GAIN_SHIFT;
+    int32_t error = (int32_t)PID_Speed.setpoint - measured;
+    if (error > INT16_MAX) {
+        error = INT16_MAX;
+    } else if (error < INT16_MIN) {
+        error = INT16_MIN;
+    }
+
+    // Integrator with clamping anti-windup
+    int32_t integral = PID_Speed.integral + (int32_t)PID_Speed.ki * (int16_t)error;
+    if (integral < 0) {
+        integral = 0;
+    } else if (integral > limit) {
+        integral = limit;
+    }
+    PID_Speed.integral = integral;
+
+    // Derivative on the measurement, low-pass filtered
+    int32_t slope = PID_Speed.slope;
+    slope += (((int32_t)PID_Speed.measured - measured) * (1 << PID_GAIN_SHIFT) - slope) >> PID_D_FILTER_SHIFT;
+    PID_Speed.slope = slope;
+    PID_Speed.measured = measured;
+    int32_t change = slope >> PID_GAIN_SHIFT;
+    if (change > INT16_MAX) {
+        change = INT16_MAX;
+    } else if (change < INT16_MIN) {
+        change = INT16_MIN;
+    }
+
+    // Both products fit in 31 bits; limit their sum before adding the integrator
+    int32_t output = (int32_t)PID_Speed.kp * (int16_t)error + (int32_t)PID_Speed.kd * (int16_t)change;
+    if (output > limit) {
+        output = limit;
+    } else if (output < -limit) {
+        output = -limit;
+    }
+    output += integral;
+    if (output < 0) {
+        output = 0;
+    } else if (output > limit) {
+        output = limit;
+    }
+    PID_Speed.duty = output >> PID_GAIN_SHIFT;
+    return PID_Speed.duty;
+}
+
+/**
+ * @brief Runs the speed controller (TCA0 control tick).
+ *
+ * @details A duty refused because a PWM update is still pending is replaced by the
+ *          next tick's value.
+ */
+void PID_Tick() {
+    if (!PID_Speed.enabled) {
+        return;
+    }
+    SPEED_SNAPSHOT speed;
+    SPEED_Read(&speed);
+    TLE9201SG_Drive(PID_Step(speed.rpm));
+}
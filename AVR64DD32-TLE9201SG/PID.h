@@ -0,0 +1,43 @@
+/**
+ * @file PID.h
+ * @brief Header file for the fixed-point PID speed controller.
+ *
+ * @details Runs in the TCA0 control tick on the speed measured by TCB2 (Speed.c) and
+ *          drives the duty cycle. Integer arithmetic only: gains are Q8.8, the output is
+ *          the driver's Q16 duty (a fraction of 65536), which PWM_Compare() scales onto
+ *          the TCD compare range.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef PID_H_
+#define PID_H_
+
+/** @brief Fractional bits of the PID gains (Q8.8). */
+#define PID_GAIN_SHIFT 8
+
+/** @brief Derivative low-pass filter: each tick moves 1/2^n of the way to the new slope. */
+#define PID_D_FILTER_SHIFT 3
+
+/**
+ * @struct PID_DATA
+ * @brief Structure for storing the speed controller state and tuning.
+ */
+typedef struct {
+    uint16_t setpoint;  ///< Target speed in RPM.
+    uint16_t measured;  ///< Last speed used, in RPM.
+    int16_t kp;         ///< Proportional gain, duty steps per RPM (Q8.8).
+    int16_t ki;         ///< Integral gain, duty steps per RPM and tick (Q8.8).
+    int16_t kd;         ///< Derivative gain, duty steps per RPM/tick (Q8.8).
+    int32_t integral;   ///< Integrator in duty steps (Q8), held within 0 and `limit`.
+    int32_t slope;      ///< Filtered speed change per tick in RPM (Q8).
+    uint16_t limit;     ///< Highest duty the controller may apply, follows the duty ramp.
+    uint16_t duty;      ///< Duty applied by the controller, as a fraction of 65536.
+    uint8_t enabled;    ///< 1 while the controller drives the duty.
+} PID_DATA;
+
+/** @brief Global variable for storing the speed controller state. */
+extern volatile PID_DATA PID_Speed;
+
+#endif /* PID_H_ */
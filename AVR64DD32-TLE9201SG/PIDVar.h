@@ -0,0 +1,32 @@
+/**
+ * @file PIDVar.h
+ * @brief Initialization of the speed controller global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef PIDVAR_H_
+#define PIDVAR_H_
+
+#include "PID.h" ///< Include the header file for the PID_DATA structure definition.
+
+/**
+ * @brief Global instance of PID_DATA structure.
+ *
+ * @details Starts disabled with conservative gains for the 1 kHz tick; tune them for
+ *          the motor and the tick rate with PID_set_gains().
+ */
+volatile PID_DATA PID_Speed = {
+    .setpoint = 1000,   ///< 1000 RPM.
+    .kp = 16 << PID_GAIN_SHIFT, ///< 16 duty steps per RPM.
+    .ki = 1 << (PID_GAIN_SHIFT - 2), ///< 0.25 duty steps per RPM and tick.
+    .kd = 0,            ///< No derivative action.
+    .integral = 0,      ///< Outputs off.
+    .slope = 0,         ///< Speed not changing.
+    .limit = 0,         ///< Outputs off.
+    .duty = 0,          ///< Outputs off.
+    .enabled = 0        ///< Open-loop duty until PID_ON().
+};
+
+#endif /* PIDVAR_H_ */
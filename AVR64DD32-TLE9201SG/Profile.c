@@ -0,0 +1,71 @@
+/**
+ * @file Profile.c
+ * @brief Cycle-count profiler of code regions on real load.
+ *
+ * @details Compiled in only when PROFILE is defined (see Settings.h).
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+
+#ifdef PROFILE
+
+#include "ProfileVar.h"
+
+/**
+ * @brief Starts the TCB1 cycle counter the profiler reads.
+ */
+void PROFILE_init() {
+    TCB1_Cycle_init();
+}
+
+/**
+ * @brief Adds one run to the statistics of a region (PROFILE_END()).
+ *
+ * @param region Profiled region (PROFILE_* id).
+ * @param cycles Length of the run in CLK_PER cycles.
+ */
+void PROFILE_Record(uint8_t region, uint16_t cycles) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ///< Regions run in interrupts too
+        volatile PROFILE_ENTRY *entry = &PROFILE_Table[region];
+        if (cycles < entry->min) {
+            entry->min = cycles;
+        }
+        if (cycles > entry->max) {
+            entry->max = cycles;
+        }
+        if (entry->count == 0xFFFF) {
+            entry->sum >>= 1; // Keep the mean, weight recent runs more
+            entry->count >>= 1;
+        }
+        entry->sum += cycles;
+        entry->count++;
+    }
+}
+
+/**
+ * @brief Copies the statistics of a region and optionally starts it over.
+ *
+ * @param region Profiled region (PROFILE_* id).
+ * @param entry Receives the statistics.
+ * @param reset 1 to clear the region after copying.
+ */
+void PROFILE_Read(uint8_t region, PROFILE_ENTRY *entry, uint8_t reset) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        volatile PROFILE_ENTRY *source = &PROFILE_Table[region];
+        entry->min = source->min;
+        entry->max = source->max;
+        entry->sum = source->sum;
+        entry->count = source->count;
+        if (reset) {
+            source->min = 0xFFFF;
+            source->max = 0;
+            source->sum = 0;
+            source->count = 0;
+        }
+    }
+}
+
+#endif /* PROFILE */
@@ -0,0 +1,64 @@
+/**
+ * @file Profile.h
+ * @brief Header file for the cycle-count profiler.
+ *
+ * @details PROFILE_BEGIN() and PROFILE_END() bracket a code region and record its
+ *          length in CLK_PER cycles, read from the free-running TCB1 counter, into
+ *          PROFILE_Table (minimum, maximum, sum and count for the mean). Without
+ *          PROFILE (see Settings.h) the macros expand to nothing. Regions must be
+ *          shorter than 65536 cycles. The table is read with COMMAND_PROFILE.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+/** @brief Profiled region: TLE9201SG_START(). */
+#define PROFILE_START 0
+
+/** @brief Profiled region: PWM_init(). */
+#define PROFILE_PWM_INIT 1
+
+/** @brief Profiled region: SPI0 transfer complete interrupt (response handling and the next frame). */
+#define PROFILE_SPI_COMPLETE 2
+
+/** @brief Profiled region: TCA0 control tick (ramp and speed controller). */
+#define PROFILE_CONTROL_TICK 3
+
+/** @brief Profiled region: COMMAND_Task(). */
+#define PROFILE_COMMAND_TASK 4
+
+/** @brief Profiled region: TELEMETRY_Task(). */
+#define PROFILE_TELEMETRY_TASK 5
+
+/** @brief Number of profiled regions in PROFILE_Table. */
+#define PROFILE_REGIONS 6
+
+#ifdef PROFILE
+/** @brief Starts timing a region; place it at the top of a block. */
+#define PROFILE_BEGIN(region) uint16_t profile_##region = TCB1_CYCLES()
+
+/** @brief Records the cycles since the PROFILE_BEGIN() of the same region. */
+#define PROFILE_END(region) PROFILE_Record((region), TCB1_CYCLES() - profile_##region)
+#else
+#define PROFILE_BEGIN(region)
+#define PROFILE_END(region)
+#endif
+
+/**
+ * @struct PROFILE_ENTRY
+ * @brief Statistics of one profiled region.
+ */
+typedef struct {
+    uint16_t min;   ///< Shortest run in cycles (0xFFFF before the first run).
+    uint16_t max;   ///< Longest run in cycles.
+    uint32_t sum;   ///< Sum of the runs, `sum / count` is the mean.
+    uint16_t count; ///< Number of runs (halved together with `sum` before it overflows).
+} PROFILE_ENTRY;
+
+/** @brief Global table of the profiled regions. */
+extern volatile PROFILE_ENTRY PROFILE_Table[PROFILE_REGIONS];
+
+#endif /* PROFILE_H_ */
@@ -0,0 +1,29 @@
+/**
+ * @file ProfileVar.h
+ * @brief Initialization of the profiler table.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef PROFILEVAR_H_
+#define PROFILEVAR_H_
+
+#include "Profile.h" ///< Include the header file for the PROFILE_ENTRY structure definition.
+
+/** @brief Entry of a region that has not run yet. */
+#define PROFILE_EMPTY { .min = 0xFFFF, .max = 0, .sum = 0, .count = 0 }
+
+/**
+ * @brief Global table of PROFILE_ENTRY structures, one per region.
+ */
+volatile PROFILE_ENTRY PROFILE_Table[PROFILE_REGIONS] = {
+    [PROFILE_START] = PROFILE_EMPTY,
+    [PROFILE_PWM_INIT] = PROFILE_EMPTY,
+    [PROFILE_SPI_COMPLETE] = PROFILE_EMPTY,
+    [PROFILE_CONTROL_TICK] = PROFILE_EMPTY,
+    [PROFILE_COMMAND_TASK] = PROFILE_EMPTY,
+    [PROFILE_TELEMETRY_TASK] = PROFILE_EMPTY
+};
+
+#endif /* PROFILEVAR_H_ */
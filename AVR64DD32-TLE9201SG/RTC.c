@@ -0,0 +1,35 @@
+/**
+ * @file RTC.c
+ * @brief Real Time Counter (RTC) periodic interrupt used as the system tick.
+ *
+ * @details The Periodic Interrupt Timer (PIT) runs from the internal 32.768 kHz
+ *          oscillator, keeps running in idle sleep and drives input debouncing.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+
+/** @brief Free-running tick counter, RTC_TICK_HZ ticks per second. */
+volatile uint32_t RTC_Ticks = 0;
+
+/**
+ * @brief Initializes the RTC periodic interrupt at RTC_TICK_HZ.
+ */
+void RTC_init() {
+    while (RTC.PITSTATUS & RTC_CTRLBUSY_bm); ///< Wait until PIT is ready for configuration
+    RTC.CLKSEL = RTC_CLKSEL_OSC32K_gc; ///< 32.768 kHz internal oscillator
+    RTC.PITINTCTRL = RTC_PI_bm; ///< Enable periodic interrupt
+    RTC.PITCTRLA = RTC_PERIOD_CYC32_gc | ///< 32768 Hz / 32 = 1024 Hz
+                   RTC_PITEN_bm; ///< Enable PIT
+}
+
+/**
+ * @brief RTC periodic interrupt: advances the tick and debounces inputs.
+ */
+ISR(RTC_PIT_vect) {
+    RTC.PITINTFLAGS = RTC_PI_bm;
+    RTC_Ticks++;
+    GPIO_Debounce();
+}
@@ -0,0 +1,18 @@
+/**
+ * @file RTC.h
+ * @brief Header file for the RTC periodic interrupt system tick.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef RTC_H_
+#define RTC_H_
+
+/** @brief RTC tick frequency: 32.768 kHz OSC32K divided by 32. */
+#define RTC_TICK_HZ 1024
+
+/** @brief Free-running tick counter incremented by the RTC periodic interrupt. */
+extern volatile uint32_t RTC_Ticks;
+
+#endif /* RTC_H_ */
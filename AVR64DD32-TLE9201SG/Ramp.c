@@ -0,0 +1,173 @@
+/**
+ * @file Ramp.c
+ * @brief Duty cycle ramp generator for soft start, speed changes and braking.
+ *
+ * @details RAMP_Tick() runs in the TCA0 control tick and moves the applied duty
+ *          toward the target by at most one slew step, applying it through
+ *          TLE9201SG_Apply_Duty(). The main loop only sets targets and never waits.
+ *          A direction change ramps the duty down, waits the dead time at zero duty,
+ *          flips the direction and ramps back up, all from the tick. Neither mode is
+ *          off at zero duty by itself: SPI mode holds SPWM off (see
+ *          TLE9201SG_SPI_Timing()), PWM/DIR mode holds DIS high through the dead time
+ *          (see TLE9201SG_Hold()).
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+#include "RampVar.h"
+
+/**
+ * @brief Sets the ramp slew rates.
+ *
+ * @param rise Duty step per tick when increasing (see RAMP_SLEW()), 0 for no limit.
+ * @param fall Duty step per tick when decreasing, 0 for no limit.
+ * @param brake Duty step per tick when stopping, 0 to switch the outputs off at once.
+ */
+void RAMP_set_slew(uint16_t rise, uint16_t fall, uint16_t brake) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        RAMP.rise = rise;
+        RAMP.fall = fall;
+        RAMP.brake = brake;
+    }
+}
+
+/**
+ * @brief Sets the dead time of a direction change.
+ *
+ * @param ticks Control ticks spent at zero duty before the direction flips.
+ */
+void RAMP_set_deadtime(uint16_t ticks) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        RAMP.deadtime = ticks;
+    }
+}
+
+/**
+ * @brief Starts ramping the applied duty toward a new target.
+ *
+ * @details Also cancels a braking ramp in progress; the duty turns around from
+ *          where it is. A direction change in progress is finished first and the
+ *          duty ramps up to the new target after it.
+ *
+ * @param target Duty cycle as a fraction of 65536.
+ */
+void RAMP_set_target(uint16_t target) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        RAMP.target = target;
+        if (RAMP.state == RAMP_IDLE || RAMP.state == RAMP_BRAKE) {
+            RAMP.state = RAMP.reverse ? RAMP_REVERSE : RAMP_RUN;
+        }
+    }
+}
+
+/**
+ * @brief Restarts the ramp from zero duty (outputs are off).
+ *
+ * @details A pending direction change is applied right away, the bridge is not driving.
+ */
+void RAMP_Reset() {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (RAMP.reverse) {
+            TLE9201SG_Apply_Dir(RAMP.direction);
+            RAMP.reverse = 0;
+        }
+        RAMP.duty = 0;
+        RAMP.target = 0;
+        RAMP.state = RAMP_IDLE;
+    }
+}
+
+/**
+ * @brief Requests a direction change while the outputs run.
+ *
+ * @details The tick ramps the duty to zero at the braking rate, waits the dead time,
+ *          applies `direction` and ramps back to the target. A newer request during
+ *          the sequence only replaces the direction. Returns at once.
+ *
+ * @param direction Direction to apply (0 or 1).
+ */
+void RAMP_Reverse(uint8_t direction) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        RAMP.direction = direction;
+        RAMP.reverse = 1;
+        if (RAMP.state == RAMP_IDLE || RAMP.state == RAMP_RUN) {
+            RAMP.state = RAMP_REVERSE;
+        }
+    }
+}
+
+/**
+ * @brief Starts the braking ramp toward zero duty.
+ *
+ * @return 1 if braking started (the tick switches the outputs off at zero duty),
+ *         0 if braking is disabled and the outputs must be switched off at once.
+ */
+uint8_t RAMP_Brake() {
+    if (!RAMP.brake) {
+        return 0;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        RAMP.target = 0;
+        RAMP.state = RAMP_BRAKE;
+    }
+    return 1;
+}
+
+/**
+ * @brief Moves the applied duty one step toward the target (TCA0 control tick).
+ *
+ * @details If the driver cannot take the new duty yet (a PWM update is still
+ *          pending) the step is retried on the next tick.
+ */
+void RAMP_Tick() {
+    if (RAMP.state == RAMP_IDLE) {
+        return;
+    }
+    if (RAMP.state == RAMP_DEADTIME) {
+        if (RAMP.wait) {
+            RAMP.wait--;
+            return;
+        }
+        if (TLE9201SG.mode && TLE9201SG.SPWM) {
+            return; // SPI mode: the last frame still drives, the next edge holds SPWM off
+        }
+        TLE9201SG_Apply_Dir(RAMP.direction); // Bridge is held off, safe to flip
+        TLE9201SG_Hold(0);
+        RAMP.reverse = 0;
+        RAMP.state = RAMP_RUN;
+    }
+
+    uint8_t down = (RAMP.state == RAMP_BRAKE || RAMP.state == RAMP_REVERSE);
+    uint16_t duty = RAMP.duty;
+    uint16_t target = (RAMP.state == RAMP_REVERSE) ? 0 : RAMP.target;
+    if (duty < target) {
+        uint16_t step = RAMP.rise;
+        duty = (step && target - duty > step) ? duty + step : target;
+    } else if (duty > target) {
+        uint16_t step = down ? RAMP.brake : RAMP.fall;
+        duty = (step && duty - target > step) ? duty - step : target;
+    }
+
+    if (duty != RAMP.duty && TLE9201SG_Apply_Duty(duty)) {
+        RAMP.duty = duty;
+    }
+
+    if (RAMP.duty == target) {
+        switch (RAMP.state) {
+            case RAMP_BRAKE:
+                TLE9201SG_OFF(); // Braked to zero, switch the outputs off
+                RAMP_Reset();
+                break;
+            case RAMP_REVERSE:
+                TLE9201SG_Hold(1); // PWM/DIR mode: double slope still pulses at zero duty
+                RAMP.wait = RAMP.deadtime;
+                RAMP.state = RAMP_DEADTIME;
+                break;
+            default:
+                RAMP.state = RAMP_IDLE;
+                break;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * @file Ramp.h
+ * @brief Header file for the duty cycle ramp generator (soft start and braking).
+ *
+ * @details The applied duty moves toward a target by a limited step every control
+ *          tick (TCA0), so the motor current does not jump when the driver starts,
+ *          changes speed, stops or reverses.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef RAMP_H_
+#define RAMP_H_
+
+/** @brief Ramp is idle, the applied duty equals the target. */
+#define RAMP_IDLE 0
+
+/** @brief Ramp moves the duty toward the target. */
+#define RAMP_RUN 1
+
+/** @brief Ramp brakes toward zero duty and switches the outputs off at the end. */
+#define RAMP_BRAKE 2
+
+/** @brief Ramp brings the duty to zero before a direction change. */
+#define RAMP_REVERSE 3
+
+/** @brief Duty is zero, waiting for the dead time before the direction change. */
+#define RAMP_DEADTIME 4
+
+/**
+ * @brief Converts a slew rate in percent per second to a duty step per control tick.
+ * @param percent_per_s Slew rate in percent of full duty per second.
+ * @return Duty step per TCA0 tick as a fraction of 65536.
+ */
+#define RAMP_SLEW(percent_per_s) ((uint16_t)(((uint32_t)(percent_per_s) * 0xFFFFUL) / (100UL * TCA0_TICK_HZ)))
+
+/**
+ * @brief Converts a time in milliseconds to control ticks.
+ * @param ms Time in milliseconds.
+ * @return Number of TCA0 ticks.
+ */
+#define RAMP_MS(ms) ((uint16_t)(((uint32_t)(ms) * TCA0_TICK_HZ) / 1000))
+
+/**
+ * @struct RAMP_DATA
+ * @brief Structure for storing the ramp generator state and slew rates.
+ */
+typedef struct {
+    uint16_t target; ///< Duty the ramp moves to, as a fraction of 65536.
+    uint16_t duty;   ///< Duty currently applied to the driver.
+    uint16_t rise;   ///< Duty step per tick when increasing, 0 for no limit.
+    uint16_t fall;   ///< Duty step per tick when decreasing, 0 for no limit.
+    uint16_t brake;  ///< Duty step per tick when stopping or reversing, 0 to stop at once.
+    uint16_t deadtime; ///< Ticks at zero duty before the direction changes.
+    uint16_t wait;   ///< Dead time ticks left.
+    uint8_t direction; ///< Direction to apply after the dead time.
+    uint8_t reverse; ///< 1 while a direction change is pending.
+    uint8_t state;   ///< RAMP_IDLE, RAMP_RUN, RAMP_BRAKE, RAMP_REVERSE or RAMP_DEADTIME.
+} RAMP_DATA;
+
+/** @brief Global variable for storing the ramp generator state. */
+extern volatile RAMP_DATA RAMP;
+
+#endif /* RAMP_H_ */
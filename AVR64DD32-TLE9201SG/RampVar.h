@@ -0,0 +1,32 @@
+/**
+ * @file RampVar.h
+ * @brief Initialization of the duty cycle ramp generator global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef RAMPVAR_H_
+#define RAMPVAR_H_
+
+#include "Ramp.h" ///< Include the header file for the RAMP_DATA structure definition.
+
+/**
+ * @brief Global instance of RAMP_DATA structure.
+ *
+ * @details Default slew rates: full duty is reached in 0.5 s and left in 0.25 s
+ *          when braking or reversing. Change them with RAMP_set_slew() and the
+ *          reversal dead time with RAMP_set_deadtime().
+ */
+volatile RAMP_DATA RAMP = {
+    .target = 0,              ///< Outputs off.
+    .duty = 0,                ///< Outputs off.
+    .rise = RAMP_SLEW(200),   ///< 0 to 100% in 0.5 s.
+    .fall = RAMP_SLEW(200),   ///< 100 to 0% in 0.5 s.
+    .brake = RAMP_SLEW(400),  ///< 100 to 0% in 0.25 s on stop.
+    .deadtime = RAMP_MS(20),  ///< 20 ms at zero duty before reversing.
+    .reverse = 0,             ///< No direction change pending.
+    .state = RAMP_IDLE        ///< Nothing to do.
+};
+
+#endif /* RAMPVAR_H_ */
@@ -3,13 +3,15 @@
  * @brief SPI initialization and control functions for AVR64DD32 microcontroller.
  *
  * @details This file contains functions for initializing the SPI0 module, 
- *          starting and stopping communication with the SPI slave device.
+ *          starting and stopping communication with the SPI slave device and
+ *          the interrupt-driven frame queue used to exchange data with it.
  * 
  * @author Saulius
  * @date 2025-01-10
  */
 
 #include "Settings.h"
+#include "SPIVar.h"
 
 /**
  * @brief Initializes the SPI0 module for communication.
@@ -17,13 +19,19 @@
  * @details 
  * - Configures SPI0 as a Master with a clock speed of 6 MHz (F_CPU/4).
  * - Sets SPI mode 1 for communication with TLE9201SG.
- * - Enables the SPI0 module.
+ * - Enables the SPI0 module and its transfer complete interrupt.
+ * - Empties the frame queue.
  */
 void SPI0_init() {
     SPI0.CTRLA = SPI_MASTER_bm          // Configure as Master
                | SPI_PRESC_DIV4_gc      // Clock speed = F_CPU / 4 = 24 MHz / 4 = 6 MHz
                | SPI_ENABLE_bm;         // Enable SPI
     SPI0.CTRLB = SPI_MODE_1_gc;         // Set SPI mode 1 for TLE9201SG
+    SPI0.INTCTRL = SPI_IE_bm;           // Interrupt when a frame has been exchanged
+
+    SPI0_Queue.head = 0;
+    SPI0_Queue.tail = 0;
+    SPI0_Queue.busy = 0;
 }
 
 /**
@@ -48,21 +56,124 @@ void SPI0_Stop() {
     PORTA.OUTSET = PIN7_bm; // Set SS (PA7) high
 }
 
+/**
+ * @brief Puts the frame at the queue tail on the bus.
+ *
+ * Pulls SS low and loads the data register; the SPI0 interrupt finishes the frame.
+ * With TLE9201SG_SIMULATION defined the software model answers immediately instead.
+ */
+void SPI0_Transmit() {
+    SPI0_Start(); // Pull SS low to initiate communication
+#ifdef TLE9201SG_SIMULATION
+    SPI0_Stop();
+    SPI0_Complete(TLE9201SG_Sim_Exchange(SPI0_Queue.frame[SPI0_Queue.tail].data));
+#else
+    SPI0.DATA = SPI0_Queue.frame[SPI0_Queue.tail].data; // Send the data
+#endif
+}
+
+/**
+ * @brief Queues a single SPI0 frame.
+ *
+ * The frame is sent as soon as all earlier frames are exchanged. If the engine
+ * is idle, transmission starts immediately. Safe to call from interrupts.
+ *
+ * @param data The byte of data to send to the SPI slave.
+ * @param callback Function called from the SPI0 interrupt when the frame completes (may be NULL).
+ * @return 1 if the frame was queued, 0 if the queue is full.
+ */
+uint8_t SPI0_Enqueue(uint8_t data, SPI0_Callback callback) {
+    uint8_t queued = 0;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        uint8_t head = SPI0_Queue.head;
+        uint8_t next = (head + 1) & (SPI0_QUEUE_SIZE - 1);
+
+        if (next != SPI0_Queue.tail) {
+            SPI0_Queue.frame[head].data = data;
+            SPI0_Queue.frame[head].callback = callback;
+            SPI0_Queue.head = next;
+            queued = 1;
+
+            if (!SPI0_Queue.busy) { // Engine idle, start right away
+                SPI0_Queue.busy = 1;
+                SPI0_Transmit();
+            }
+        }
+    }
+    return queued;
+}
+
+/**
+ * @brief Returns the number of frames not yet exchanged.
+ *
+ * @return 0 when the engine is idle, otherwise queued frames including the one on the bus.
+ */
+uint8_t SPI0_Pending() {
+    return (SPI0_Queue.head - SPI0_Queue.tail) & (SPI0_QUEUE_SIZE - 1);
+}
+
+/**
+ * @brief Waits until every queued frame has been exchanged.
+ */
+void SPI0_Flush() {
+    while (SPI0_Queue.busy) {}
+}
+
+/**
+ * @brief Finishes the frame at the queue tail.
+ *
+ * Starts the next queued frame (if any) and then reports the finished frame
+ * to its callback.
+ *
+ * @param received The byte received while the frame was sent.
+ */
+void SPI0_Complete(uint8_t received) {
+    uint8_t tail = SPI0_Queue.tail;
+    uint8_t sent = SPI0_Queue.frame[tail].data;
+    SPI0_Callback callback = SPI0_Queue.frame[tail].callback;
+
+    SPI0_Queue.received = received;
+    SPI0_Queue.tail = tail = (tail + 1) & (SPI0_QUEUE_SIZE - 1);
+
+    if (tail != SPI0_Queue.head) {
+        SPI0_Transmit(); // Next frame goes out before the callback runs
+    } else {
+        SPI0_Queue.busy = 0;
+    }
+
+    if (callback) {
+        callback(sent, received);
+    }
+}
+
+/**
+ * @brief SPI0 transfer complete interrupt.
+ *
+ * Releases SS and finishes the frame. Every SPI-mode PWM edge ends here, so this
+ * is the SPI path profiled as PROFILE_SPI_COMPLETE.
+ */
+ISR(SPI0_INT_vect) {
+    PROFILE_BEGIN(PROFILE_SPI_COMPLETE);
+    uint8_t received = SPI0.DATA; // Reading DATA after the flag clears SPI_IF
+    SPI0_Stop(); // Pull SS high to terminate communication
+    SPI0_Complete(received);
+    PROFILE_END(PROFILE_SPI_COMPLETE);
+}
+
 /**
  * @brief Exchanges a byte of data via SPI0.
  *
  * This function transmits a single byte of data to an SPI slave device and 
  * simultaneously receives a byte of data from the slave device.
- * It ensures the SPI communication is correctly initiated and terminated by 
- * managing the slave select (SS) line.
+ * It queues the frame behind any pending ones and blocks until it is exchanged,
+ * so it is meant for initialization code only. Global interrupts must be enabled.
  *
  * @param data_storage The byte of data to send to the SPI slave.
  * @return The byte of data received from the SPI slave.
  */
 uint8_t SPI0_Exchange_Data(uint8_t data_storage) {
-    SPI0_Start(); // Pull SS low to initiate communication
-    SPI0.DATA = data_storage; // Send the data
-    while (!(SPI0.INTFLAGS & SPI_IF_bm)) {} // Wait until data is exchanged
-    SPI0_Stop(); // Pull SS high to terminate communication
-    return SPI0.DATA; // Return the received data
+    while (!SPI0_Enqueue(data_storage, 0)) {} // Wait for a free slot
+    SPI0_Flush(); // Wait until data is exchanged
+    return SPI0_Queue.received; // Return the received data
 }
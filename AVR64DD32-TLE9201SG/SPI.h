@@ -0,0 +1,53 @@
+/**
+ * @file SPI.h
+ * @brief Header file for the interrupt-driven SPI0 transaction engine.
+ *
+ * @details Frames are queued with SPI0_Enqueue() and shifted out by the SPI0
+ *          interrupt, which also drives the Slave Select (SS) line and calls the
+ *          completion callback of each frame. The main loop is free while frames move.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef SPI_H_
+#define SPI_H_
+
+/** @brief Number of slots in the SPI0 frame queue (power of two, one slot stays free). */
+#define SPI0_QUEUE_SIZE 8
+
+/**
+ * @brief Completion callback of a queued SPI0 frame.
+ *
+ * Called from the SPI0 interrupt right after the frame has been exchanged.
+ *
+ * @param sent The byte that was transmitted.
+ * @param received The byte that was received while transmitting.
+ */
+typedef void (*SPI0_Callback)(uint8_t sent, uint8_t received);
+
+/**
+ * @struct SPI0_FRAME
+ * @brief Single queued SPI0 frame.
+ */
+typedef struct {
+    uint8_t data;           ///< Byte to transmit.
+    SPI0_Callback callback; ///< Completion callback (NULL if not needed).
+} SPI0_FRAME;
+
+/**
+ * @struct SPI0_QUEUE
+ * @brief Ring buffer and state of the SPI0 transaction engine.
+ */
+typedef struct {
+    SPI0_FRAME frame[SPI0_QUEUE_SIZE]; ///< Queued frames, `frame[tail]` is the one on the bus.
+    uint8_t head;     ///< Index of the next free slot.
+    uint8_t tail;     ///< Index of the frame being exchanged.
+    uint8_t busy;     ///< 1 while a frame is on the bus.
+    uint8_t received; ///< Last byte received from the slave.
+} SPI0_QUEUE;
+
+/** @brief Global SPI0 transaction engine state. */
+extern volatile SPI0_QUEUE SPI0_Queue;
+
+#endif /* SPI_H_ */
@@ -0,0 +1,26 @@
+/**
+ * @file SPIVar.h
+ * @brief Initialization of the SPI0 transaction engine global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef SPIVAR_H_
+#define SPIVAR_H_
+
+#include "SPI.h" ///< Include the header file for the SPI0_QUEUE structure definition.
+
+/**
+ * @brief Global instance of SPI0_QUEUE structure.
+ *
+ * @details The queue starts empty and the engine idle.
+ */
+volatile SPI0_QUEUE SPI0_Queue = {
+    .head = 0,     ///< Queue is empty.
+    .tail = 0,     ///< Queue is empty.
+    .busy = 0,     ///< No frame on the bus.
+    .received = 0  ///< Nothing received yet.
+};
+
+#endif /* SPIVAR_H_ */
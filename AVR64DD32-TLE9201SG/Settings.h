@@ -8,13 +8,102 @@
 #ifndef SETTINGS_H_
 #define SETTINGS_H_
 
-/** @brief Defines the default CPU frequency (24 MHz). */
+/**
+ * @brief Replaces the TLE9201SG by a software model (TLE9201SGSim.c).
+ *
+ * Uncomment to run the driver without the chip, e.g. on a bare board or in simavr.
+ * SPI0 frames are answered by TLE9201SG_Sim_Exchange() instead of the SPI0 hardware.
+ */
+// #define TLE9201SG_SIMULATION
+
+/**
+ * @brief Runs the cycle-count benchmark (Benchmark.c) instead of the application.
+ *
+ * Uncomment to build the benchmark image; results are left in BENCHMARK_Result
+ * and BENCHMARK_Summary and reported over USART1 (read them with Tools/benchmark.py).
+ */
+// #define BENCHMARK
+
+/**
+ * @brief Dithers the TCD0 duty cycle between adjacent compare values.
+ *
+ * Uncomment to get the full 16-bit duty resolution of PWM_set_duty() on average
+ * without lowering the PWM frequency. Costs one TCD0 overflow interrupt per period.
+ */
+// #define PWM_DITHER
+
+/**
+ * @brief Regulates the motor current instead of the duty cycle in PWM/DIR mode.
+ *
+ * Uncomment if a shunt amplifier is connected to PD2. The duty ramp then limits the
+ * duty the current regulator (Current.c) may apply.
+ */
+// #define CURRENT_CONTROL
+
+/**
+ * @brief Regulates the motor speed measured on the encoder input (PC2).
+ *
+ * Uncomment to let the PID speed controller (PID.c) set the duty; the duty ramp then
+ * limits the duty it may apply. Cannot be combined with CURRENT_CONTROL.
+ */
+// #define SPEED_CONTROL
+
+/**
+ * @brief Records cycle counts of the profiled regions (Profile.c).
+ *
+ * Uncomment to fill PROFILE_Table with minimum, maximum and mean cycles of the regions
+ * bracketed by PROFILE_BEGIN() and PROFILE_END(); read it with COMMAND_PROFILE.
+ * Uses TCB1, like the benchmark, and cannot be combined with BENCHMARK.
+ */
+// #define PROFILE
+
+/**
+ * @brief Builds histograms of the PWM period and its jitter (Jitter.c).
+ *
+ * Uncomment to timestamp every SPI-mode PWM period or TCD0 overflow with TCB1 and
+ * count the deviation from the nominal period and the cycle-to-cycle change; read
+ * them with COMMAND_JITTER. Keeps the TCD0 overflow interrupt running in PWM/DIR mode.
+ */
+// #define JITTER
+
+#if defined(PROFILE) && defined(BENCHMARK)
+#error "PROFILE would add its own cycles to the BENCHMARK results, choose one"
+#endif
+
+#if defined(SPEED_CONTROL) && defined(CURRENT_CONTROL)
+#error "SPEED_CONTROL and CURRENT_CONTROL both set the duty, choose one"
+#endif
+
+/** @brief Defines the default CPU frequency (24 MHz), can be overridden from the build. */
+#ifndef F_CPU
 #define F_CPU 24000000
+#endif
 
 #include <avr/io.h>
 #include <util/delay.h>
 #include <avr/cpufunc.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+#include "CLK.h"
+#include "GPIO.h"
+#include "RTC.h"
+#include "SPI.h"
+#include "TCA.h"
+#include "TCD.h"
+#include "Ramp.h"
+#include "Current.h"
+#include "Speed.h"
+#include "PID.h"
+#include "USART.h"
+#include "Telemetry.h"
+#include "Jitter.h"
+#include "Command.h"
+#include "DiagLog.h"
+#include "Profile.h"
+#include "Benchmark.h"
 #include "TLE9201SG.h"
+#include "TLE9201SGSim.h"
 
 /** @brief Initializes the crystal oscillator in high-frequency mode. */
 void CLOCK_XOSCHF_crystal_init();
@@ -28,9 +117,12 @@ void CLOCK_INHF_clock_init();
 /** @brief Configures the Phase-Locked Loop (PLL). */
 void PLL_init();
 
+/** @brief Decodes the clock registers into the cached clock tree (CLOCK_Tree). */
+void CLOCK_update();
+
 /** 
  * @brief Reads the current clock configuration.
- * @return The current clock frequency in Hz.
+ * @return The cached TCD0 clock frequency in Hz.
  */
 uint32_t CLOCK_read();
 
@@ -43,16 +135,354 @@ void TCD0_ON();
 /** @brief Disables Timer/Counter D0. */
 void TCD0_OFF();
 
+/**
+ * @brief Converts a duty cycle in percent to the fixed-point duty used by the driver.
+ * @param percent Duty cycle in percent (0 to 100).
+ * @return Duty cycle as a fraction of 65536 (0xFFFF is 100%).
+ */
+#define PWM_DUTY_PERCENT(percent) ((uint16_t)(((uint32_t)(percent) * 0xFFFFUL) / 100))
+
 /**
  * @brief Configures PWM with a specified frequency and duty cycle.
  * @param target_freq Desired PWM frequency in Hz.
- * @param duty_cycle Desired duty cycle as a percentage (0.0 to 100.0).
+ * @param duty_cycle Desired duty cycle as a fraction of 65536 (see PWM_DUTY_PERCENT()).
  */
-void PWM_init(uint32_t target_freq, float duty_cycle);
+void PWM_init(uint32_t target_freq, uint16_t duty_cycle);
+
+/**
+ * @brief Initializes TCB0 as a periodic interrupt timer.
+ * @param clksel TCB clock selection.
+ */
+void TCB0_init(uint8_t clksel);
+
+/** @brief Enables Timer/Counter B0. */
+void TCB0_ON();
+
+/** @brief Disables Timer/Counter B0. */
+void TCB0_OFF();
+
+/** @brief Starts TCB1 as a free-running CLK_PER cycle counter. */
+void TCB1_Cycle_init();
+
+/** @brief Reads the TCB1 cycle counter (wraps every 65536 CLK_PER cycles). */
+#define TCB1_CYCLES() (TCB1.CNT)
+
+/**
+ * @brief Plans TCD0 clock source, prescalers and waveform mode for a PWM frequency.
+ * @param target_freq PWM frequency in Hz.
+ * @param min_resolution Minimum duty steps per period.
+ * @param plan Receives the configuration with achieved frequency and resolution.
+ * @return 1 if the minimum resolution is reached, 0 otherwise.
+ */
+uint8_t PWM_plan(uint32_t target_freq, uint16_t min_resolution, TCD0_PLAN *plan);
+
+/**
+ * @brief Finds the smallest TCD0 prescaler that keeps a PWM period within 12 bits.
+ * @param source TCD0 clock source frequency in Hz.
+ * @param target_freq PWM frequency in Hz.
+ * @param wgmode TCD_WGMODE_DS_gc or TCD_WGMODE_ONERAMP_gc.
+ * @return TCD0.CTRLA prescaler bits.
+ */
+uint8_t PWM_prescaler(uint32_t source, uint32_t target_freq, uint8_t wgmode);
+
+/**
+ * @brief Applies a PWM_plan() result to TCD0 (stops the timer).
+ * @param plan Configuration to apply.
+ */
+void PWM_apply(const TCD0_PLAN *plan);
+
+/**
+ * @brief Stages a new PWM duty cycle, committed at the end of the TCD cycle.
+ * @param duty_cycle Duty cycle as a fraction of 65536.
+ * @return 1 if staged, 0 if a previous update is still pending.
+ */
+uint8_t PWM_set_duty(uint16_t duty_cycle);
+
+/**
+ * @brief Writes the TCD0 compare values for a period and duty cycle (not committed).
+ * @param cmpbclr Period value (CMPBCLR).
+ * @param duty_cycle Duty cycle as a fraction of 65536.
+ */
+void PWM_Compare(uint16_t cmpbclr, uint16_t duty_cycle);
+
+/** @brief Commits the staged compare values at the end of the TCD cycle. */
+void PWM_Commit();
+
+/**
+ * @brief Stages a new PWM frequency, committed at the end of the TCD cycle.
+ * @param target_freq PWM frequency in Hz.
+ * @return 1 if staged, 0 if an update is still pending or the period is out of range.
+ */
+uint8_t PWM_set_freq(uint32_t target_freq);
+
+/**
+ * @brief Tells whether a staged PWM update is still pending.
+ * @return 1 if pending, 0 otherwise.
+ */
+uint8_t PWM_pending();
 
 /** @brief Initializes GPIO pins. */
 void GPIO_init();
 
+/** @brief Debounces PF5/PF6 and queues input events (called from the RTC tick). */
+void GPIO_Debounce();
+
+/**
+ * @brief Takes the oldest debounced input event.
+ * @param state Receives the PORTF input state (low = pressed).
+ * @return 1 if an event was returned, 0 if none is queued.
+ */
+uint8_t GPIO_Event_Get(uint8_t *state);
+
+/** @brief Sleeps in idle mode until an interrupt if no input event is queued. */
+void GPIO_Event_Wait();
+
+/** @brief Initializes the RTC periodic interrupt system tick. */
+void RTC_init();
+
+/** @brief Starts the TCA0 control tick at TCA0_TICK_HZ. */
+void TCA0_Tick_init();
+
+/**
+ * @brief Sets the duty ramp slew rates (see RAMP_SLEW()).
+ * @param rise Step per tick when increasing, 0 for no limit.
+ * @param fall Step per tick when decreasing, 0 for no limit.
+ * @param brake Step per tick when stopping, 0 to stop at once.
+ */
+void RAMP_set_slew(uint16_t rise, uint16_t fall, uint16_t brake);
+
+/**
+ * @brief Ramps the applied duty toward a new target.
+ * @param target Duty cycle as a fraction of 65536.
+ */
+void RAMP_set_target(uint16_t target);
+
+/**
+ * @brief Sets the dead time of a direction change.
+ * @param ticks Control ticks at zero duty before the direction flips.
+ */
+void RAMP_set_deadtime(uint16_t ticks);
+
+/** @brief Restarts the ramp from zero duty, applying a pending direction change. */
+void RAMP_Reset();
+
+/**
+ * @brief Ramps down, waits the dead time and changes direction (non-blocking).
+ * @param direction Direction to apply (0 or 1).
+ */
+void RAMP_Reverse(uint8_t direction);
+
+/**
+ * @brief Starts the braking ramp toward zero duty.
+ * @return 1 if braking, 0 if braking is disabled.
+ */
+uint8_t RAMP_Brake();
+
+/** @brief Moves the applied duty one step toward the target (called from the TCA0 tick). */
+void RAMP_Tick();
+
+/** @brief Initializes ADC0 and the TCD0 event that starts a current sample every PWM period. */
+void CURRENT_init();
+
+/** @brief Places the current sample in the middle of the PWM output pulse. */
+void CURRENT_Delay();
+
+/**
+ * @brief Sets the target current.
+ * @param setpoint Current in ADC counts (see CURRENT_MA()).
+ */
+void CURRENT_set(uint16_t setpoint);
+
+/**
+ * @brief Sets the current regulator gains.
+ * @param kp Proportional gain (Q4).
+ * @param ki Integral gain (Q4).
+ */
+void CURRENT_set_gains(int16_t kp, int16_t ki);
+
+/** @brief Hands the duty over to the current regulator. */
+void CURRENT_ON();
+
+/** @brief Returns the duty to the open-loop ramp. */
+void CURRENT_OFF();
+
+/**
+ * @brief Runs one current regulator step.
+ * @param measured Current sample in ADC counts.
+ * @return New duty cycle as a fraction of 65536.
+ */
+uint16_t CURRENT_Regulate(uint16_t measured);
+
+/** @brief Initializes the PC2 encoder input and TCB2 speed measurement. */
+void SPEED_init();
+
+/**
+ * @brief Takes a consistent copy of the latest speed measurement (lock-free).
+ * @param snapshot Receives period, RPM and pulse count.
+ */
+void SPEED_Read(SPEED_SNAPSHOT *snapshot);
+
+/**
+ * @brief Sets the target speed of the speed controller.
+ * @param rpm Speed in revolutions per minute.
+ */
+void PID_set(uint16_t rpm);
+
+/**
+ * @brief Sets the speed controller gains (Q8.8).
+ * @param kp Proportional gain.
+ * @param ki Integral gain.
+ * @param kd Derivative gain.
+ */
+void PID_set_gains(int16_t kp, int16_t ki, int16_t kd);
+
+/** @brief Hands the duty over to the speed controller. */
+void PID_ON();
+
+/** @brief Returns the duty to the open-loop ramp. */
+void PID_OFF();
+
+/**
+ * @brief Runs one speed controller step.
+ * @param measured Speed in RPM.
+ * @return New duty cycle as a fraction of 65536.
+ */
+uint16_t PID_Step(uint16_t measured);
+
+/** @brief Runs the speed controller (called from the TCA0 tick). */
+void PID_Tick();
+
+/** @brief Initializes USART1 (PC0 TX, PC1 RX) at USART1_BAUD, 8N1. */
+void USART1_init();
+
+/**
+ * @brief Starts sending a buffer in the background (zero-copy).
+ * @param data Bytes to send, must stay valid until USART1_Busy() returns 0.
+ * @param length Number of bytes.
+ * @return 1 if started, 0 if a transmission is still in progress.
+ */
+uint8_t USART1_Send(const uint8_t *data, uint8_t length);
+
+/**
+ * @brief Returns the USART1 transmitter status.
+ * @return Bytes still to be sent (0 when idle).
+ */
+uint8_t USART1_Busy();
+
+/**
+ * @brief Takes the next received byte out of the USART1 ring buffer.
+ * @param byte Receives the byte.
+ * @return 1 if a byte was read, 0 if the buffer is empty.
+ */
+uint8_t USART1_Read(uint8_t *byte);
+
+/**
+ * @brief COBS encodes a block and appends the 0x00 delimiter.
+ * @param data Bytes to encode (up to 254).
+ * @param length Number of bytes.
+ * @param frame Receives `length` + 2 bytes.
+ * @return Length of the encoded frame.
+ */
+uint8_t TELEMETRY_Encode(const uint8_t *data, uint8_t length, uint8_t *frame);
+
+/**
+ * @brief Calculates the CRC-16/CCITT-FALSE of a block.
+ * @param data Bytes to check.
+ * @param length Number of bytes.
+ * @return CRC, sent little endian after the block.
+ */
+uint16_t TELEMETRY_CRC(const uint8_t *data, uint8_t length);
+
+/**
+ * @brief Sets the telemetry rate.
+ * @param rate Frames per second, 0 to stop the stream.
+ */
+void TELEMETRY_set_rate(uint16_t rate);
+
+/** @brief Takes and sends telemetry frames on schedule (main loop, never blocks). */
+void TELEMETRY_Task();
+
+/**
+ * @brief Decodes a COBS frame in place.
+ * @param frame Encoded frame without the delimiter; receives the decoded bytes.
+ * @param length Encoded length.
+ * @return Decoded length, 0 if the frame is malformed.
+ */
+uint8_t COMMAND_Decode(uint8_t *frame, uint8_t length);
+
+/**
+ * @brief Executes one request.
+ * @param request Decoded request without the CRC.
+ * @param length Request length.
+ * @param reply Receives the reply payload (COMMAND_REPLY_MAX bytes).
+ * @return Reply length.
+ */
+uint8_t COMMAND_Execute(const uint8_t *request, uint8_t length, uint8_t *reply);
+
+/** @brief Parses received commands and sends the replies (main loop, bounded time). */
+void COMMAND_Task();
+
+/** @brief Starts recording diagnosis changes (installs the TLE9201SG diagnosis and latch hooks). */
+void DIAG_init();
+
+/**
+ * @brief Records a diagnosis change (TLE9201SG diagnosis hook).
+ * @param previous The previous diagnosis byte.
+ * @param diag The new diagnosis byte.
+ */
+void DIAG_Record(uint8_t previous, uint8_t diag);
+
+/**
+ * @brief Records a TCD0 fault latch change (TLE9201SG latch hook).
+ * @param latched 1 when the latch tripped, 0 when it recovered.
+ */
+void DIAG_Record_Latch(uint8_t latched);
+
+/**
+ * @brief Copies one diagnosis history entry (lock-free).
+ * @param number Entry number, one of the last DIAG_LOG_SIZE before `DIAG_Log.head`.
+ * @param entry Receives the entry.
+ * @return 1 if copied, 0 if not written yet or overwritten.
+ */
+uint8_t DIAG_Get(uint8_t number, DIAG_ENTRY *entry);
+
+/**
+ * @brief Copies the fault counters (lock-free).
+ * @param count Receives DIAG_CLASSES counters.
+ * @return History head the counters belong to.
+ */
+uint8_t DIAG_Counters(uint16_t *count);
+
+/** @brief Starts the TCB1 cycle counter used by the profiler. */
+void PROFILE_init();
+
+/**
+ * @brief Adds one run to the statistics of a profiled region.
+ * @param region Profiled region (PROFILE_* id).
+ * @param cycles Length of the run in CLK_PER cycles.
+ */
+void PROFILE_Record(uint8_t region, uint16_t cycles);
+
+/**
+ * @brief Copies the statistics of a profiled region.
+ * @param region Profiled region (PROFILE_* id).
+ * @param entry Receives the statistics.
+ * @param reset 1 to clear the region after copying.
+ */
+void PROFILE_Read(uint8_t region, PROFILE_ENTRY *entry, uint8_t reset);
+
+/** @brief Starts the TCB1 cycle counter and clears the period histograms. */
+void JITTER_init();
+
+/** @brief Clears the period histograms and takes the nominal period from the PWM frequency. */
+void JITTER_Reset();
+
+/** @brief Ends the period measurement when the PWM stops, keeping the histograms. */
+void JITTER_Stop();
+
+/** @brief Marks the start of a PWM period (interrupt context). */
+void JITTER_Mark();
+
 /** @brief Initializes the SPI0 interface. */
 void SPI0_init();
 
@@ -62,6 +492,34 @@ void SPI0_Start();
 /** @brief Stops the SPI0 communication. */
 void SPI0_Stop();
 
+/**
+ * @brief Queues a frame on the interrupt-driven SPI0 engine.
+ * @param data Byte to send.
+ * @param callback Called from the SPI0 interrupt with the sent and received bytes (may be NULL).
+ * @return 1 if queued, 0 if the queue is full.
+ */
+uint8_t SPI0_Enqueue(uint8_t data, SPI0_Callback callback);
+
+/**
+ * @brief Returns the SPI0 engine status.
+ * @return Number of frames not yet exchanged (0 when idle).
+ */
+uint8_t SPI0_Pending();
+
+/** @brief Waits until all queued SPI0 frames are exchanged. */
+void SPI0_Flush();
+
+/**
+ * @brief Finishes the SPI0 frame on the bus and starts the next one.
+ * @param received Byte received with the frame.
+ */
+void SPI0_Complete(uint8_t received);
+
+/**
+ * @brief Exchanges a byte via SPI0 and waits for the answer (blocking).
+ * @param data_storage Byte to send.
+ * @return Byte received from the slave.
+ */
 uint8_t SPI0_Exchange_Data(uint8_t data_storage);
 
 /**
@@ -75,11 +533,53 @@ uint8_t TLE9201SG_Read(uint8_t command, uint8_t write);
 /** @brief Reads and displays the TLE9201SG revision information. */
 void TLE9201SG_Revision();
 
-/** @brief Sorts and processes the diagnostic data from the TLE9201SG. */
+/** @brief Updates the fault status from the TLE9201SG diagnosis data. */
 void TLE9201SG_Sort_Diagnosis();
 
-/** @brief Performs control-related actions for the TLE9201SG. */
-void TLE9201SG_Sort_Control();
+/**
+ * @brief Returns the fault status, derived from the diagnosis byte when it changed.
+ * @return SPI mode: DIA value; PWM/DIR mode: 1 while TCD0 holds a fault; 0 if no fault.
+ */
+uint8_t TLE9201SG_Fault_Status();
+
+/**
+ * @brief Holds the bridge off through a direction change (PWM/DIR mode, DIS pin).
+ * @param hold 1 to disable the outputs, 0 to enable them again.
+ */
+void TLE9201SG_Hold(uint8_t hold);
+
+/**
+ * @brief Sets the hook called from the SPI0 interrupt when the diagnosis byte changes.
+ * @param hook Hook function, NULL to remove it.
+ */
+void TLE9201SG_set_hook(TLE9201SG_Diag_Hook hook);
+
+/**
+ * @brief Sets the hook called when the TCD0 fault latch trips or recovers.
+ * @param hook Hook function, NULL to remove it.
+ */
+void TLE9201SG_set_latch_hook(TLE9201SG_Latch_Hook hook);
+
+/**
+ * @brief Builds a TLE9201SG frame from a command and the control bits.
+ * @param command Command bits (e.g. WR_CTRL_RD_DIA).
+ * @return Complete frame.
+ */
+uint8_t TLE9201SG_Write(uint8_t command);
+
+/**
+ * @brief Queues a frame for the TLE9201SG and attributes its answer.
+ * @param frame Complete frame to send.
+ * @return 1 if queued, 0 if the SPI0 queue is full.
+ */
+uint8_t TLE9201SG_Send(uint8_t frame);
+
+/**
+ * @brief Calculates the SPI-mode PWM on/off times into TLE9201SG.on and TLE9201SG.off.
+ * @param duty_cycle Duty cycle as a fraction of 65536.
+ * @return TCB0 clock selection the times are calculated for.
+ */
+uint8_t TLE9201SG_SPI_Timing(uint16_t duty_cycle);
 
 /**
  * @brief Initializes the TLE9201SG with the specified mode.
@@ -88,15 +588,90 @@ void TLE9201SG_Sort_Control();
 void TLE9201SG_Mode_init(uint8_t mode);
 
 /**
- * @brief Sets the direction of the TLE9201SG.
+ * @brief Sets the direction of the TLE9201SG, reversing along the ramp while running.
  * @param direction 1 for forward, 0 for reverse.
  */
 void TLE9201SG_DIR(uint8_t direction);
 
+/**
+ * @brief Applies a direction to the TLE9201SG at once.
+ * @param direction 1 for forward, 0 for reverse.
+ */
+void TLE9201SG_Apply_Dir(uint8_t direction);
+
+/**
+ * @brief Tells whether the driver outputs are running.
+ * @return Non-zero if running.
+ */
+uint8_t TLE9201SG_Running();
+
 /** @brief Starts the TLE9201SG operation. */
 void TLE9201SG_START();
 
-/** @brief Stops the TLE9201SG operation. */
+/** @brief Stops the TLE9201SG operation, braking along the ramp. */
 void TLE9201SG_STOP();
 
+/** @brief Turns off the TLE9201SG outputs at once. */
+void TLE9201SG_OFF();
+
+/**
+ * @brief Drives the outputs with a duty cycle.
+ * @param duty_cycle Duty cycle as a fraction of 65536.
+ * @return 1 if applied, 0 if a previous PWM update is still pending.
+ */
+uint8_t TLE9201SG_Drive(uint16_t duty_cycle);
+
+/**
+ * @brief Applies a duty cycle from the ramp (a limit while a regulator runs).
+ * @param duty_cycle Duty cycle as a fraction of 65536.
+ * @return 1 if applied, 0 if a previous PWM update is still pending.
+ */
+uint8_t TLE9201SG_Apply_Duty(uint16_t duty_cycle);
+
+/**
+ * @brief Changes the configured duty cycle, ramping to it while running.
+ * @param duty_cycle Duty cycle as a fraction of 65536.
+ */
+void TLE9201SG_Set_Duty(uint16_t duty_cycle);
+
+/**
+ * @brief Changes the PWM frequency (any time in PWM/DIR mode, while stopped in SPI mode).
+ * @param freq PWM frequency in Hz.
+ * @return 1 if applied, 0 if it cannot be applied now.
+ */
+uint8_t TLE9201SG_Set_Freq(uint16_t freq);
+
+/**
+ * @brief Switches the control mode while the outputs are off.
+ * @param mode TLE9201SG_MODE_SPI or TLE9201SG_MODE_PWMDIR.
+ * @return 1 if switched, 0 if the outputs are running.
+ */
+uint8_t TLE9201SG_Set_Mode(uint8_t mode);
+
+/**
+ * @brief Clears a latched fault in PWM/DIR mode once the fault flag is gone.
+ * @return 1 if recovered, 0 if the fault is still active.
+ */
+uint8_t TLE9201SG_Fault_Recover();
+
+/** @brief Runs the cycle-count benchmark and reports the results forever (BENCHMARK builds only). */
+void BENCHMARK_run();
+
+/** @brief Resets the TLE9201SG software model and its frame counters. */
+void TLE9201SG_Sim_Reset();
+
+/**
+ * @brief Exchanges one frame with the TLE9201SG software model.
+ * @param frame Frame sent to the model.
+ * @return Answer to the previous frame.
+ */
+uint8_t TLE9201SG_Sim_Exchange(uint8_t frame);
+
+/**
+ * @brief Injects a fault into the TLE9201SG software model.
+ * @param flags Any of TLE9201SG_SIM_OT_bm, TLE9201SG_SIM_TV_bm, TLE9201SG_SIM_CL_bm.
+ * @param dia Diagnosis code (TLE9201SG_SIM_DIA_OK for none).
+ */
+void TLE9201SG_Sim_Inject(uint8_t flags, uint8_t dia);
+
 #endif /* SETTINGS_H_ */
@@ -0,0 +1,86 @@
+/**
+ * @file Speed.c
+ * @brief Encoder speed measurement with TCB2 frequency capture.
+ *
+ * @details TCB2 counts TCA0 prescaler ticks (CLK_PER / TCA0_TICK_DIV) and restarts on
+ *          every encoder edge, so the captured value is the pulse period. The capture
+ *          interrupt turns it into RPM with one integer division; a counter overflow
+ *          (no pulse for 65536 ticks) reports the motor as stopped. The main loop reads
+ *          the result without disabling interrupts through SPEED_Read().
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+#include "SpeedVar.h"
+
+/**
+ * @brief Initializes the encoder input and TCB2 frequency measurement.
+ *
+ * @details Needs the TCA0 control tick running, TCB2 counts its prescaled clock
+ *          (about 175 ms full scale at 24 MHz, so speeds down to roughly 30 RPM with
+ *          12 pulses per revolution).
+ */
+void SPEED_init() {
+    PORTC.DIRCLR = PIN2_bm; ///< Encoder input
+    PORTC.PIN2CTRL = PORT_PULLUPEN_bm; ///< Open-collector hall sensors need a pull-up
+
+    EVSYS.CHANNEL2 = EVSYS_CHANNEL2_PORTC_PIN2_gc; ///< Encoder on PC2
+    EVSYS.USERTCB2CAPT = EVSYS_USER_CHANNEL2_gc; ///< Feed it to TCB2 capture
+
+    SPEED.scale = 60UL * (CLOCK_Tree.per / TCA0_TICK_DIV) / SPEED_PULSES_PER_REV;
+
+    TCB2.CTRLB = TCB_CNTMODE_FRQ_gc; ///< Capture the period and restart on every edge
+    TCB2.EVCTRL = TCB_CAPTEI_bm | ///< Capture on the event input
+                  TCB_FILTER_bm; ///< Ignore glitches shorter than four samples
+    TCB2.INTFLAGS = TCB_CAPT_bm | TCB_OVF_bm;
+    TCB2.INTCTRL = TCB_CAPT_bm | TCB_OVF_bm; ///< Period ready or motor stopped
+    TCB2.CTRLA = TCB_CLKSEL_TCA0_gc | ///< Count TCA0 prescaler ticks
+                 TCB_ENABLE_bm; ///< Enable TCB2
+}
+
+/**
+ * @brief Takes a consistent copy of the latest speed measurement.
+ *
+ * @details Lock-free: the copy is repeated if the TCB2 interrupt updated the
+ *          measurement in the middle of it. Interrupts stay enabled.
+ *
+ * @param snapshot Receives the measurement.
+ */
+void SPEED_Read(SPEED_SNAPSHOT *snapshot) {
+    uint8_t sequence;
+    do {
+        sequence = SPEED.sequence;
+        snapshot->period = SPEED.value.period;
+        snapshot->rpm = SPEED.value.rpm;
+        snapshot->pulses = SPEED.value.pulses;
+    } while (sequence != SPEED.sequence);
+}
+
+/**
+ * @brief TCB2 interrupt: new pulse period captured or counter overflow.
+ */
+ISR(TCB2_INT_vect) {
+    uint8_t flags = TCB2.INTFLAGS;
+
+    if (flags & TCB_OVF_bm) { // No pulse for a full counter range
+        TCB2.INTFLAGS = TCB_OVF_bm;
+        SPEED.stalled = 1;
+        SPEED.value.period = 0;
+        SPEED.value.rpm = 0;
+        SPEED.sequence++;
+    }
+    if (flags & TCB_CAPT_bm) {
+        uint16_t period = TCB2.CCMP; ///< Reading the capture clears the flag
+        SPEED.value.pulses++;
+        if (SPEED.stalled || !period) { // First edge after standstill, no full period yet
+            SPEED.stalled = 0;
+        } else {
+            uint32_t rpm = SPEED.scale / period;
+            SPEED.value.period = period;
+            SPEED.value.rpm = (rpm > 0xFFFF) ? 0xFFFF : rpm;
+        }
+        SPEED.sequence++;
+    }
+}
@@ -0,0 +1,43 @@
+/**
+ * @file Speed.h
+ * @brief Header file for the encoder speed measurement on TCB2.
+ *
+ * @details Encoder or hall pulses on PC2 reach TCB2 through EVSYS channel 2. TCB2 in
+ *          frequency measurement mode captures the time between rising edges in TCA0
+ *          prescaler ticks, and the capture interrupt converts it to RPM.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef SPEED_H_
+#define SPEED_H_
+
+/** @brief Encoder pulses (rising edges) per motor revolution. */
+#define SPEED_PULSES_PER_REV 12
+
+/**
+ * @struct SPEED_SNAPSHOT
+ * @brief Consistent copy of the latest speed measurement, see SPEED_Read().
+ */
+typedef struct {
+    uint16_t period; ///< Time between the last two pulses in TCB2 ticks, 0 if stopped.
+    uint16_t rpm;    ///< Motor speed in revolutions per minute.
+    uint16_t pulses; ///< Pulses counted since initialization (wraps).
+} SPEED_SNAPSHOT;
+
+/**
+ * @struct SPEED_DATA
+ * @brief Structure for storing the speed measurement written by the TCB2 interrupt.
+ */
+typedef struct {
+    SPEED_SNAPSHOT value; ///< Latest measurement.
+    uint32_t scale;       ///< RPM times period: 60 * TCB2 clock / SPEED_PULSES_PER_REV.
+    uint8_t sequence;     ///< Incremented after every update, lets readers detect a torn copy.
+    uint8_t stalled;      ///< 1 after a counter overflow, the next capture is not a full period.
+} SPEED_DATA;
+
+/** @brief Global variable for storing the speed measurement. */
+extern volatile SPEED_DATA SPEED;
+
+#endif /* SPEED_H_ */
@@ -0,0 +1,26 @@
+/**
+ * @file SpeedVar.h
+ * @brief Initialization of the speed measurement global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef SPEEDVAR_H_
+#define SPEEDVAR_H_
+
+#include "Speed.h" ///< Include the header file for the SPEED_DATA structure definition.
+
+/**
+ * @brief Global instance of SPEED_DATA structure.
+ *
+ * @details Reads as stopped until two pulses have been seen; `scale` is set by SPEED_init().
+ */
+volatile SPEED_DATA SPEED = {
+    .value = { 0, 0, 0 }, ///< Stopped, no pulses.
+    .scale = 0,           ///< Set from the clock tree.
+    .sequence = 0,        ///< No update yet.
+    .stalled = 1          ///< First capture has no previous edge.
+};
+
+#endif /* SPEEDVAR_H_ */
@@ -0,0 +1,39 @@
+/**
+ * @file TCA.c
+ * @brief Timer/Counter A (TCA0) periodic interrupt used as the control tick.
+ *
+ * @details TCA0 overflows at TCA0_TICK_HZ from CLK_PER and runs the background
+ *          control tasks (duty ramp, speed controller) without involving the main loop.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+
+/**
+ * @brief Initializes TCA0 as a periodic interrupt at TCA0_TICK_HZ.
+ *
+ * @details The period is calculated from the cached CLK_PER frequency, so call it
+ *          after the main clock is set up.
+ */
+void TCA0_Tick_init() {
+    TCA0.SINGLE.CTRLA = 0; ///< Stop while configuring
+    TCA0.SINGLE.CTRLB = TCA_SINGLE_WGMODE_NORMAL_gc; ///< Count to PER and overflow
+    TCA0.SINGLE.PER = CLOCK_Tree.per / ((uint32_t)TCA0_TICK_DIV * TCA0_TICK_HZ) - 1;
+    TCA0.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm;
+    TCA0.SINGLE.INTCTRL = TCA_SINGLE_OVF_bm; ///< Interrupt on every overflow
+    TCA0.SINGLE.CTRLA = TCA_SINGLE_CLKSEL_DIV64_gc | ///< CLK_PER / 64
+                        TCA_SINGLE_ENABLE_bm; ///< Enable TCA0
+}
+
+/**
+ * @brief TCA0 overflow interrupt: runs the control tasks once per tick.
+ */
+ISR(TCA0_OVF_vect) {
+    PROFILE_BEGIN(PROFILE_CONTROL_TICK);
+    TCA0.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm;
+    RAMP_Tick();
+    PID_Tick();
+    PROFILE_END(PROFILE_CONTROL_TICK);
+}
@@ -0,0 +1,20 @@
+/**
+ * @file TCA.h
+ * @brief Header file for the TCA0 periodic control tick.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef TCA_H_
+#define TCA_H_
+
+/** @brief Control tick frequency in Hz (1 to 10 kHz), can be overridden from the build. */
+#ifndef TCA0_TICK_HZ
+#define TCA0_TICK_HZ 1000
+#endif
+
+/** @brief TCA0 prescaler used for the control tick. */
+#define TCA0_TICK_DIV 64
+
+#endif /* TCA_H_ */
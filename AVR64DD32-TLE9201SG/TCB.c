@@ -0,0 +1,59 @@
+/**
+ * @file TCB.c
+ * @brief Functions for configuring and controlling Timer/Counter B (TCB) on the AVR64DD32 microcontroller.
+ *
+ * @details TCB0 runs in periodic interrupt mode and schedules the on/off edges
+ *          of the PWM signal emulated over SPI in TLE9201SG SPI mode. TCB1 is a
+ *          free-running cycle counter used for timing measurements.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+
+/**
+ * @brief Initializes TCB0 as a periodic interrupt timer.
+ *
+ * @details The counter restarts and raises the CAPT interrupt every time it reaches CCMP.
+ *          The timer is left disabled; use TCB0_ON() to start it.
+ *
+ * @param clksel TCB clock selection (e.g. TCB_CLKSEL_DIV1_gc or TCB_CLKSEL_DIV2_gc).
+ */
+void TCB0_init(uint8_t clksel) {
+    TCB0.CTRLA = clksel;               ///< Select clock, keep the timer disabled
+    TCB0.CTRLB = TCB_CNTMODE_INT_gc;   ///< Periodic interrupt mode
+    TCB0.INTFLAGS = TCB_CAPT_bm;       ///< Clear a stale interrupt flag
+    TCB0.INTCTRL = TCB_CAPT_bm;        ///< Interrupt on every compare match
+}
+
+/**
+ * @brief Turns on the TCB0 counter.
+ *
+ * @details Restarts counting from zero so the first period is a full CCMP.
+ */
+void TCB0_ON() {
+    TCB0.CNT = 0; ///< Start a fresh period
+    TCB0.CTRLA |= TCB_ENABLE_bm; ///< Enable the TCB0 counter
+}
+
+/**
+ * @brief Turns off the TCB0 counter.
+ */
+void TCB0_OFF() {
+    TCB0.CTRLA &= ~TCB_ENABLE_bm; ///< Disable the TCB0 counter
+    TCB0.INTFLAGS = TCB_CAPT_bm; ///< Drop a pending edge
+}
+
+/**
+ * @brief Initializes TCB1 as a free-running cycle counter.
+ *
+ * @details Counts CLK_PER cycles over the full 16-bit range without interrupts.
+ *          Read it with TCB1_CYCLES(); differences of two reads are valid up to 65535 cycles.
+ */
+void TCB1_Cycle_init() {
+    TCB1.CCMP = 0xFFFF;              ///< Wrap at the full 16-bit range
+    TCB1.CTRLB = TCB_CNTMODE_INT_gc; ///< Periodic interrupt mode, interrupt stays disabled
+    TCB1.CTRLA = TCB_CLKSEL_DIV1_gc | ///< Count CLK_PER cycles
+                 TCB_ENABLE_bm;      ///< Enable the TCB1 counter
+}
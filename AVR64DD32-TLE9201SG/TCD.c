@@ -4,33 +4,264 @@
  * 
  * @details This file includes functions to initialize TCD, control its on/off state,
  *          and configure it for PWM generation with adjustable frequency and duty cycle.
+ *          Runtime changes are staged and committed at the end of a TCD cycle.
+ *          PWM_plan() picks clock source, prescalers and waveform mode for a frequency.
+ *          With PWM_DITHER the on-time alternates between adjacent counts so the
+ *          average duty keeps all 16 bits.
  * 
  * @author Saulius
  * @date 2025-01-09
  */
 
 #include "Settings.h"
+#include "TCDVar.h"
 
 /**
  * @brief Turns on the TCD0 counter.
  * 
  * @details Waits until the TCD is ready to be enabled, then activates the timer.
+ *          With PWM_DITHER the overflow interrupt is started for a fractional duty,
+ *          with JITTER always.
  */
 void TCD0_ON() {
     while (!(TCD0.STATUS & TCD_ENRDY_bm)); ///< Wait until the TCD is ready
     TCD0.CTRLA |= TCD_ENABLE_bm; ///< Enable the TCD0 counter
+#ifdef JITTER
+    TCD0.INTFLAGS = TCD_OVF_bm;
+    TCD0.INTCTRL |= TCD_OVF_bm; ///< Timestamp every period
+#endif
+#ifdef PWM_DITHER
+    if (TCD0_PWM.fraction) {
+        TCD0.INTFLAGS = TCD_OVF_bm;
+        TCD0.INTCTRL |= TCD_OVF_bm; ///< Dither from the first period
+    }
+#endif
 }
 
 /**
  * @brief Turns off the TCD0 counter.
  * 
  * @details Waits until the TCD is ready to be disabled, then deactivates the timer.
+ *          A staged PWM update is no longer pending; it is loaded on the next enable.
  */
 void TCD0_OFF() {
     while (!(TCD0.STATUS & TCD_ENRDY_bm)); ///< Wait until the TCD is ready
     TCD0.CTRLA &= ~TCD_ENABLE_bm; ///< Disable the TCD0 counter
+    TCD0.INTCTRL &= ~TCD_OVF_bm;
+    TCD0_PWM.pending = 0;
+#ifdef JITTER
+    JITTER_Stop();
+#endif
+}
+
+
+/**
+ * @brief Calculates the TCD period (CMPBCLR) for a PWM frequency.
+ *
+ * @param target_freq The target frequency of the PWM signal in Hz.
+ * @return CMPBCLR value for the current clock, prescalers and waveform mode
+ *         (double slope counts up and down, one ramp only up). Not limited to
+ *         TCD_PERIOD_MAX, so callers can check the range.
+ */
+uint32_t PWM_Period(uint32_t target_freq) {
+    uint8_t ramps = (TCD0_PWM.wgmode == TCD_WGMODE_DS_gc) ? 2 : 1;
+    return (CLOCK_read() / ((uint32_t)TCD0_PWM.divider * target_freq * ramps)) - 1;
+}
+
+/**
+ * @brief Prescaler settings in ascending order of total division.
+ *
+ * @details CNTPRES is preferred over SYNCPRES for the same division so the
+ *          synchronizer keeps running as fast as possible.
+ */
+const struct {
+    uint16_t divider; ///< SYNCPRES times CNTPRES.
+    uint8_t ctrla;    ///< TCD0.CTRLA prescaler bits.
+} PWM_Prescaler[] = {
+    {   1, TCD_SYNCPRES_DIV1_gc | TCD_CNTPRES_DIV1_gc },
+    {   2, TCD_SYNCPRES_DIV2_gc | TCD_CNTPRES_DIV1_gc },
+    {   4, TCD_SYNCPRES_DIV1_gc | TCD_CNTPRES_DIV4_gc },
+    {   8, TCD_SYNCPRES_DIV2_gc | TCD_CNTPRES_DIV4_gc },
+    {  16, TCD_SYNCPRES_DIV4_gc | TCD_CNTPRES_DIV4_gc },
+    {  32, TCD_SYNCPRES_DIV1_gc | TCD_CNTPRES_DIV32_gc },
+    {  64, TCD_SYNCPRES_DIV2_gc | TCD_CNTPRES_DIV32_gc },
+    { 128, TCD_SYNCPRES_DIV4_gc | TCD_CNTPRES_DIV32_gc },
+    { 256, TCD_SYNCPRES_DIV8_gc | TCD_CNTPRES_DIV32_gc }
+};
+
+/**
+ * @brief Finds the smallest prescaler that keeps a PWM period within 12 bits.
+ *
+ * @details Same rule as PWM_plan(), for a clock source and waveform mode chosen by
+ *          the caller.
+ *
+ * @param source TCD0 clock source frequency in Hz.
+ * @param target_freq The target frequency of the PWM signal in Hz.
+ * @param wgmode TCD_WGMODE_DS_gc or TCD_WGMODE_ONERAMP_gc.
+ * @return TCD0.CTRLA prescaler bits (the largest prescaler if none fits).
+ */
+uint8_t PWM_prescaler(uint32_t source, uint32_t target_freq, uint8_t wgmode) {
+    uint8_t ramps = (wgmode == TCD_WGMODE_DS_gc) ? 2 : 1;
+    uint8_t p = 0;
+    while (p < sizeof(PWM_Prescaler) / sizeof(PWM_Prescaler[0]) - 1 &&
+           source / ((uint32_t)PWM_Prescaler[p].divider * target_freq * ramps) > TCD_PERIOD_MAX + 1) {
+        p++;
+    }
+    return PWM_Prescaler[p].ctrla;
+}
+
+/**
+ * @brief Finds the TCD0 configuration with the most duty steps for a PWM frequency.
+ *
+ * @details Every available TCD clock source (OSCHF, PLL if running, XOSCHF if used)
+ *          is tried with the smallest prescaler that keeps the period within 12 bits,
+ *          which gives that source its highest resolution. Double slope (center aligned,
+ *          what the driver normally uses) is kept if it reaches `min_resolution`;
+ *          otherwise one-ramp mode, which has twice the steps, is planned.
+ *          Nothing is written to the hardware; use PWM_apply().
+ *
+ * @param target_freq The target frequency of the PWM signal in Hz.
+ * @param min_resolution Minimum number of duty steps per period.
+ * @param plan Receives the best configuration, with the achieved frequency and resolution.
+ * @return 1 if `min_resolution` is reached, 0 otherwise (`plan` still holds the best effort).
+ */
+uint8_t PWM_plan(uint32_t target_freq, uint16_t min_resolution, TCD0_PLAN *plan) {
+    const uint8_t clksel[3] = { TCD_CLKSEL_OSCHF_gc, TCD_CLKSEL_PLL_gc, TCD_CLKSEL_EXTCLK_gc };
+    const uint32_t source[3] = { CLOCK_Tree.oschf, CLOCK_Tree.pll, CLOCK_Tree.xoschf };
+    const uint8_t wgmode[2] = { TCD_WGMODE_DS_gc, TCD_WGMODE_ONERAMP_gc };
+
+    plan->resolution = 0;
+    for (uint8_t m = 0; m < 2; m++) {
+        uint8_t ramps = (wgmode[m] == TCD_WGMODE_DS_gc) ? 2 : 1;
+
+        for (uint8_t c = 0; c < 3; c++) {
+            if (!source[c]) {
+                continue; // Clock source not running
+            }
+            for (uint8_t p = 0; p < sizeof(PWM_Prescaler) / sizeof(PWM_Prescaler[0]); p++) {
+                uint32_t counts = source[c] / ((uint32_t)PWM_Prescaler[p].divider * target_freq * ramps);
+                if (counts > TCD_PERIOD_MAX + 1) {
+                    continue; // Period too long, divide more
+                }
+                if (counts >= 2 && counts > plan->resolution) {
+                    plan->ctrla = clksel[c] | PWM_Prescaler[p].ctrla;
+                    plan->wgmode = wgmode[m];
+                    plan->period = counts - 1;
+                    plan->resolution = counts;
+                    plan->freq = source[c] / ((uint32_t)PWM_Prescaler[p].divider * counts * ramps);
+                }
+                break; // Larger prescalers only lose resolution
+            }
+        }
+        if (plan->resolution >= min_resolution) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Applies a plan from PWM_plan() to TCD0.
+ *
+ * @details Stops TCD0, sets waveform mode, clock source and prescalers and refreshes
+ *          the clock tree. Call PWM_init() afterwards to load the compare values.
+ *          A plan with zero resolution is ignored.
+ *
+ * @param plan Configuration to apply.
+ */
+void PWM_apply(const TCD0_PLAN *plan) {
+    if (!plan->resolution) {
+        return;
+    }
+    TCD0_OFF();
+    TCD0.CTRLB = plan->wgmode;
+    while (!(TCD0.STATUS & TCD_ENRDY_bm)); ///< Wait until TCD is ready for configuration
+    TCD0.CTRLA = plan->ctrla;
+    CLOCK_update(); ///< TCD0 clock source changed
+}
+
+/**
+ * @brief Writes the TCD compare registers for one on-time.
+ *
+ * @param cmpbclr Period value from PWM_Period().
+ * @param count On-time compare value (CMPASET, or CMPACLR in one-ramp mode).
+ */
+void PWM_Load(uint16_t cmpbclr, uint16_t count) {
+    TCD0.CMPBCLR = cmpbclr;
+    if (TCD0_PWM.wgmode == TCD_WGMODE_ONERAMP_gc) {
+        TCD0.CMPASET = 0;
+        TCD0.CMPACLR = count;
+        return;
+    }
+    TCD0.CMPBSET = cmpbclr - count - 1;
+    TCD0.CMPASET = count;
+}
+
+/**
+ * @brief Writes the compare registers for a period and duty cycle.
+ *
+ * @details
+ * - `cmpbclr`: Determines the total period of the PWM signal based on the target frequency.
+ * - `cmpaset`: Sets the high duration of the PWM signal based on the duty cycle
+ *   (integer multiply and shift only, no floating point).
+ * - `cmpbset`: Defines the remaining time in the period (low duration).
+ *
+ * In one-ramp mode WOA is set at the start of the ramp (`cmpaset` = 0) and cleared
+ * at `cmpaclr`.
+ *
+ * The part of the on-time below one count is kept in `TCD0_PWM.fraction`; with
+ * PWM_DITHER the overflow interrupt adds it up and stretches single periods by one
+ * count, so the average duty matches `duty_cycle` to 16 bits.
+ *
+ * @param cmpbclr Period value from PWM_Period().
+ * @param duty_cycle Duty cycle as a fraction of 65536.
+ */
+void PWM_Compare(uint16_t cmpbclr, uint16_t duty_cycle) {
+    uint8_t oneramp = (TCD0_PWM.wgmode == TCD_WGMODE_ONERAMP_gc);
+    uint32_t on_time = (uint32_t)(oneramp ? cmpbclr + 1 : cmpbclr) * duty_cycle;
+    uint16_t count = (uint16_t)(on_time >> 16) + (oneramp ? 0 : 1);
+    uint16_t fraction = (uint16_t)on_time;
+
+    if (count >= cmpbclr) {
+        fraction = 0; ///< No room for a longer on-time
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ///< The dither interrupt reloads the registers too
+        TCD0_PWM.count = count;
+        TCD0_PWM.fraction = fraction;
+        PWM_Load(cmpbclr, count);
+    }
 }
 
+/**
+ * @brief Commits staged compare values at the end of the current TCD cycle.
+ *
+ * @details While TCD0 is stopped the values are taken over when it is enabled, so
+ *          nothing is left pending. Otherwise SYNCEOC is issued and the TCD0 overflow
+ *          interrupt clears the pending flag once the new values are in use. A command
+ *          written while CMDRDY is low is ignored, so the previous one (a SYNCEOC from
+ *          the dither interrupt or a RESTART) is waited out first. The overflow flag is
+ *          cleared only after CMDRDY is back, when the sync has reached the TCD clock
+ *          domain; an overflow before that still ran the old values. Each wait takes a
+ *          few TCD clock cycles.
+ */
+void PWM_Commit() {
+    if (TCD0.CTRLA & TCD_ENABLE_bm) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            while (!(TCD0.STATUS & TCD_CMDRDY_bm)); ///< A previous command is still synchronizing
+            TCD0.CTRLE = TCD_SYNCEOC_bm; ///< Load the new values at the end of the cycle
+            while (!(TCD0.STATUS & TCD_CMDRDY_bm)); ///< Wait until the sync is taken over
+#ifdef JITTER
+            if (TCD0.INTFLAGS & TCD_OVF_bm) {
+                JITTER_Mark(); ///< Do not lose the period the flag stands for
+            }
+#endif
+            TCD0.INTFLAGS = TCD_OVF_bm; ///< Only an overflow after the sync counts
+            TCD0.INTCTRL |= TCD_OVF_bm;
+            TCD0_PWM.pending = 1;
+        }
+    }
+}
 
 /**
  * @brief Initializes the PWM (Pulse Width Modulation) settings for the TLE9201SG driver.
@@ -40,40 +271,130 @@ void TCD0_OFF() {
  * based on the system clock and TCD prescaler settings.
  *
  * @param target_freq The target frequency of the PWM signal in Hz.
- * @param duty_cycle The duty cycle of the PWM signal as a percentage (0.0 to 100.0).
+ * @param duty_cycle The duty cycle of the PWM signal as a fraction of 65536 (0xFFFF is 100%).
  *
- * @note The TCD prescaler is determined from the TCD0.CTRLA register. The function
- *       supports prescaler values of 4 and 32.
+ * @note The TCD prescalers are determined from the TCD0.CTRLA register (SYNCPRES and
+ *       CNTPRES) and the waveform mode from TCD0.CTRLB. Double slope and one ramp are
+ *       supported. Use PWM_plan() and PWM_apply() first to get the best resolution.
  *
  * @note Ensure the CLOCK_read() function provides the correct system clock frequency
  *       for accurate calculations.
  *
- * @details
- * - `cmpbclr`: Determines the total period of the PWM signal based on the target frequency.
- * - `cmpaset`: Sets the high duration of the PWM signal based on the duty cycle.
- * - `cmpbset`: Defines the remaining time in the period (low duration).
+ * @note Use PWM_set_duty() and PWM_set_freq() to change the PWM while TCD0 is running.
  *
  * @warning Incorrect target frequency or duty cycle values may result in undefined behavior.
  *
  * @example
- * PWM_init(1000, 50.0f); // Initialize PWM with 1 kHz frequency and 50% duty cycle.
+ * PWM_init(1000, PWM_DUTY_PERCENT(50)); // Initialize PWM with 1 kHz frequency and 50% duty cycle.
  */
-void PWM_init(uint32_t target_freq, float duty_cycle) {
+void PWM_init(uint32_t target_freq, uint16_t duty_cycle) {
+    PROFILE_BEGIN(PROFILE_PWM_INIT);
     // Calculate TCD prescaler
-    uint8_t TCD_prescaler = 1;
+    uint16_t TCD_prescaler = 1;
     switch (TCD0.CTRLA & TCD_CNTPRES_gm) {
         case TCD_CNTPRES_DIV4_gc:  TCD_prescaler = 4; break;
         case TCD_CNTPRES_DIV32_gc: TCD_prescaler = 32; break;
     }
-    // Calculate compare registers
-    uint16_t cmpbclr = (CLOCK_read() / (TCD_prescaler * target_freq * 2)) - 1;
-    uint16_t cmpaset = (uint16_t)(cmpbclr * (duty_cycle / 100.0f)) + 1;
-    uint16_t cmpbset = cmpbclr - cmpaset - 1;
+    switch (TCD0.CTRLA & TCD_SYNCPRES_gm) {
+        case TCD_SYNCPRES_DIV2_gc: TCD_prescaler *= 2; break;
+        case TCD_SYNCPRES_DIV4_gc: TCD_prescaler *= 4; break;
+        case TCD_SYNCPRES_DIV8_gc: TCD_prescaler *= 8; break;
+    }
+    TCD0_PWM.divider = TCD_prescaler;
+    TCD0_PWM.wgmode = TCD0.CTRLB & TCD_WGMODE_gm;
+    TCD0_PWM.freq = target_freq;
+    TCD0_PWM.duty = duty_cycle;
+    TCD0_PWM.period = PWM_Period(target_freq);
+    TCD0_PWM.resolution = TCD0_PWM.period + 1;
 
-    // Set TCD compare registers
-    TCD0.CMPBCLR = cmpbclr;
-    TCD0.CMPBSET = cmpbset;
-    TCD0.CMPASET = cmpaset;
+    // Calculate and set compare registers
+    PWM_Compare(TCD0_PWM.period, duty_cycle);
+    PWM_Commit();
+    PROFILE_END(PROFILE_PWM_INIT);
+}
+
+/**
+ * @brief Tells whether a staged PWM update is still waiting for the end of the TCD cycle.
+ *
+ * @return 1 if an update is pending, 0 if a new one can be staged.
+ */
+uint8_t PWM_pending() {
+    return TCD0_PWM.pending;
+}
+
+/**
+ * @brief Changes the PWM duty cycle without disturbing the running period.
+ *
+ * @details The new compare values are staged and take effect together at the end of
+ *          the current TCD cycle. The call never blocks.
+ *
+ * @param duty_cycle Duty cycle as a fraction of 65536 (0xFFFF is 100%).
+ * @return 1 if the update was staged, 0 if a previous update is still pending.
+ */
+uint8_t PWM_set_duty(uint16_t duty_cycle) {
+    if (TCD0_PWM.pending) {
+        return 0;
+    }
+    TCD0_PWM.duty = duty_cycle;
+    PWM_Compare(TCD0_PWM.period, duty_cycle);
+    PWM_Commit();
+    return 1;
+}
+
+/**
+ * @brief Changes the PWM frequency, keeping the duty cycle.
+ *
+ * @details Staged and committed like PWM_set_duty(). The call never blocks.
+ *          The clock source and prescalers stay as they are; use PWM_plan() for
+ *          frequencies they cannot reach.
+ *
+ * @param target_freq The target frequency of the PWM signal in Hz.
+ * @return 1 if the update was staged, 0 if a previous update is still pending or
+ *         the period does not fit the current prescalers.
+ */
+uint8_t PWM_set_freq(uint32_t target_freq) {
+    if (TCD0_PWM.pending || !target_freq) {
+        return 0;
+    }
+    uint32_t period = PWM_Period(target_freq);
+    if (period < 1 || period > TCD_PERIOD_MAX) {
+        return 0;
+    }
+    TCD0_PWM.freq = target_freq;
+    TCD0_PWM.period = period;
+    TCD0_PWM.resolution = TCD0_PWM.period + 1;
+    PWM_Compare(TCD0_PWM.period, TCD0_PWM.duty);
+    PWM_Commit();
+    return 1;
+}
+
+/**
+ * @brief TCD0 overflow interrupt, fires at the end of the TCD cycle.
+ *
+ * @details The compare values staged with SYNCEOC are now in use. With PWM_DITHER
+ *          and a fractional duty the interrupt stays on: the fraction is added to the
+ *          accumulator every period and its carry lengthens the next on-time by one count
+ *          (first-order sigma-delta, the error never exceeds one count).
+ */
+ISR(TCD0_OVF_vect) {
+#ifdef JITTER
+    JITTER_Mark();
+#endif
+    TCD0.INTFLAGS = TCD_OVF_bm;
+    TCD0_PWM.pending = 0;
+#ifdef PWM_DITHER
+    if (TCD0_PWM.fraction) {
+        uint16_t dither = TCD0_PWM.dither + TCD0_PWM.fraction;
+        PWM_Load(TCD0_PWM.period, TCD0_PWM.count + (dither < TCD0_PWM.dither)); ///< Carry out of 16 bits
+        TCD0_PWM.dither = dither;
+        while (!(TCD0.STATUS & TCD_CMDRDY_bm)); ///< A RESTART may still be synchronizing
+        TCD0.CTRLE = TCD_SYNCEOC_bm; ///< Use it for the next period
+        return;
+    }
+#endif
+#ifndef JITTER
+    TCD0.INTCTRL &= ~TCD_OVF_bm;
+#endif
 }
 
 
@@ -82,14 +403,28 @@ void PWM_init(uint32_t target_freq, float duty_cycle) {
  * 
  * @details Configures the waveform generation mode, fault control, and clock source.
  *          This function also selects the WOC (Waveform Output Compare) pin configuration.
+ *          The TLE9201SG fault flag (PA5, high = fault) is routed through EVSYS channel 0
+ *          to TCD0 input A: the output is forced low in hardware and TCD0 waits for a
+ *          software restart (see TLE9201SG_Fault_Recover()).
  */
 void TCD0_init() {
     PORTMUX.TCDROUTEA = PORTMUX_TCD0_ALT4_gc; ///< Select alternative WOC pin variant 4
-    ccp_write_io((uint8_t *) &TCD0.FAULTCTRL, TCD_CMPCEN_bm); ///< Enable WOC on PD4 (pin 14)
+    ccp_write_io((uint8_t *) &TCD0.FAULTCTRL, TCD_CMPCEN_bm); ///< Enable WOC on PD4 (pin 14), low while faulted
+
+    EVSYS.CHANNEL0 = EVSYS_CHANNEL0_PORTA_PIN5_gc; ///< Fault flag on PA5
+    EVSYS.USERTCD0INPUTA = EVSYS_USER_CHANNEL0_gc; ///< Feed it to TCD0 input A
+    TCD0.EVCTRLA = TCD_CFG_ASYNC_gc | ///< Act on the outputs without waiting for the TCD clock
+                   TCD_EDGE_bm | ///< High level is a fault
+                   TCD_ACTION_FAULT_gc | ///< Event is a fault, not a capture
+                   TCD_TRIGEI_bm; ///< Enable input A
+    TCD0.INPUTCTRLA = TCD_INPUTMODE_WAITSW_gc; ///< Outputs stay off until software restart
+    TCD0.INTFLAGS = TCD_TRIGA_bm;
+    TCD0.INTCTRL |= TCD_TRIGA_bm; ///< Latch the fault in software too
 
     TCD0.CTRLB = TCD_WGMODE_DS_gc; ///< Set waveform mode to double slope
 
     while (!(TCD0.STATUS & TCD_ENRDY_bm)); ///< Wait until TCD is ready for configuration
     TCD0.CTRLA = TCD_CLKSEL_OSCHF_gc | ///< Select PLL as clock source
                  TCD_CNTPRES_DIV1_gc; ///< Select prescaler
+    CLOCK_update(); ///< TCD0 clock source changed
 }
@@ -0,0 +1,51 @@
+/**
+ * @file TCD.h
+ * @brief Header file for the TCD0 PWM state.
+ *
+ * @details Holds the compare values currently applied to TCD0 so duty and frequency
+ *          can be changed at runtime without recomputing everything from scratch, and
+ *          the clock/prescaler/waveform plan chosen for a PWM frequency.
+ *
+ * @author Saulius
+ * @date 2025-01-09
+ */
+
+#ifndef TCD_H_
+#define TCD_H_
+
+/** @brief Largest TCD period value (CMPBCLR is 12 bits wide). */
+#define TCD_PERIOD_MAX 0x0FFF
+
+/**
+ * @struct TCD0_PLAN
+ * @brief TCD0 configuration chosen by PWM_plan() for a PWM frequency.
+ */
+typedef struct {
+    uint8_t ctrla;       ///< TCD0.CTRLA value: clock source, SYNCPRES and CNTPRES (not enabled).
+    uint8_t wgmode;      ///< TCD0.CTRLB waveform mode (TCD_WGMODE_DS_gc or TCD_WGMODE_ONERAMP_gc).
+    uint16_t period;     ///< CMPBCLR value.
+    uint16_t resolution; ///< Duty steps per PWM period, 0 if the frequency cannot be reached.
+    uint32_t freq;       ///< Achieved PWM frequency in Hz.
+} TCD0_PLAN;
+
+/**
+ * @struct TCD0_PWM_DATA
+ * @brief Structure for storing the TCD0 PWM configuration.
+ */
+typedef struct {
+    uint32_t freq;       ///< PWM frequency in Hz.
+    uint16_t period;     ///< CMPBCLR value (TOP of the ramp).
+    uint16_t duty;       ///< Duty cycle as a fraction of 65536 (0xFFFF is 100%).
+    uint16_t divider;    ///< Total TCD prescaler, SYNCPRES times CNTPRES (1 to 256).
+    uint16_t resolution; ///< Duty steps per PWM period.
+    uint16_t count;      ///< On-time compare value (CMPASET, CMPACLR in one-ramp mode).
+    uint16_t fraction;   ///< Part of the on-time below one count, as a fraction of 65536.
+    uint16_t dither;     ///< Dither accumulator, carries into `count` (PWM_DITHER).
+    uint8_t wgmode;      ///< Waveform mode (TCD_WGMODE_DS_gc or TCD_WGMODE_ONERAMP_gc).
+    uint8_t pending;     ///< 1 while staged compare values wait for the end of the TCD cycle.
+} TCD0_PWM_DATA;
+
+/** @brief Global variable for storing the TCD0 PWM configuration. */
+extern volatile TCD0_PWM_DATA TCD0_PWM;
+
+#endif /* TCD_H_ */
@@ -0,0 +1,25 @@
+/**
+ * @file TCDVar.h
+ * @brief Initialization of the TCD0 PWM global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-09
+ */
+
+#ifndef TCDVAR_H_
+#define TCDVAR_H_
+
+#include "TCD.h" ///< Include the header file for the TCD0_PWM_DATA structure definition.
+
+/**
+ * @brief Global instance of TCD0_PWM_DATA structure.
+ *
+ * @details Filled in by PWM_init(); nothing is staged at reset.
+ */
+volatile TCD0_PWM_DATA TCD0_PWM = {
+    .divider = 1, ///< Prescalers after reset.
+    .wgmode = TCD_WGMODE_DS_gc, ///< Double slope as set by TCD0_init().
+    .pending = 0  ///< No update waiting.
+};
+
+#endif /* TCDVAR_H_ */
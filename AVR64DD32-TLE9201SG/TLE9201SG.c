@@ -9,46 +9,169 @@
 #include "TLE9201SGVar.h"
 
 /**
- * @brief Parses and updates the diagnosis data from the TLE9201SG.
+ * @brief Updates the fault status from the diagnosis data of the TLE9201SG.
+ *
+ * The status bits (EN, OT, TV, CL, DIA) are views of `TLE9201SG.diag` and need
+ * no decoding.
  */
 void TLE9201SG_Sort_Diagnosis() {
-	TLE9201SG.EN = GET_BIT(TLE9201SG.diag, 7);
-	TLE9201SG.OT = GET_BIT(TLE9201SG.diag, 6);
-	TLE9201SG.TV = GET_BIT(TLE9201SG.diag, 5);
-	TLE9201SG.CL = GET_BIT(TLE9201SG.diag, 4);
-	TLE9201SG.DIA = GET_BITS(TLE9201SG.diag, 0x0F);
+	TLE9201SG.Fault = (TLE9201SG.DIA != TLE9201SG_DIA_OK) ? TLE9201SG.DIA : 0;
+	TLE9201SG.dirty = 0;
+}
 
-	TLE9201SG.Fault = (TLE9201SG.DIA != 0xF) ? TLE9201SG.DIA : 0;
+/**
+ * @brief Returns the fault status, deriving it from the diagnosis byte on demand.
+ *
+ * Received diagnosis bytes only mark the fault status out of date; it is worked out
+ * here, once per change, instead of in every SPI-mode PWM edge. In PWM/DIR mode the
+ * diagnosis is not read and the TCD0 fault latch is reported instead.
+ *
+ * @return The fault status (SPI mode: DIA value; PWM/DIR mode: 1 while TCD0 holds a
+ *         fault), 0 if no fault.
+ */
+uint8_t TLE9201SG_Fault_Status() {
+    if (!TLE9201SG.mode) {
+        return TLE9201SG.latched;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (TLE9201SG.dirty) {
+            TLE9201SG_Sort_Diagnosis();
+        }
+    }
+    return TLE9201SG.Fault;
 }
 
 /**
- * @brief Parses and updates the control data from the TLE9201SG.
+ * @brief Sets the hook called when the diagnosis byte changes.
+ *
+ * @param hook Function called from the SPI0 interrupt, NULL to remove it.
  */
-void TLE9201SG_Sort_Control() {
-    TLE9201SG.CMD = (TLE9201SG.control >> 5);         // Extract Bits 7-5
-    TLE9201SG.OLDIS = GET_BIT(TLE9201SG.control, 4);  // Extract Bit 4
-    TLE9201SG.SIN = GET_BIT(TLE9201SG.control, 3);    // Extract Bit 3
-    TLE9201SG.SEN = GET_BIT(TLE9201SG.control, 2);    // Extract Bit 2
-    TLE9201SG.SDIR = GET_BIT(TLE9201SG.control, 1);   // Extract Bit 1
-    TLE9201SG.SPWM = GET_BIT(TLE9201SG.control, 0);   // Extract Bit 0
+void TLE9201SG_set_hook(TLE9201SG_Diag_Hook hook) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        TLE9201SG.hook = hook;
+    }
+}
+
+/**
+ * @brief Sets the hook called when the TCD0 fault latch trips or recovers.
+ *
+ * @param hook Function called from the TCD0 fault interrupt and from
+ *             TLE9201SG_Fault_Recover(), NULL to remove it.
+ */
+void TLE9201SG_set_latch_hook(TLE9201SG_Latch_Hook hook) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        TLE9201SG.latch_hook = hook;
+    }
 }
 
 /**
  * @brief Constructs the control command for the TLE9201SG motor driver.
  *
  * This function generates a control command for the TLE9201SG motor driver by 
- * combining the base command with various control flags.
+ * combining the base command with the control flags, which are already laid out
+ * as in the frame inside `TLE9201SG.control`.
  *
  * @param command The base command to be sent to the motor driver.
  * @return The constructed control command.
  */
 uint8_t TLE9201SG_Write(uint8_t command) {
-    return command |
-           (TLE9201SG.OLDIS << 4) |
-           (TLE9201SG.SIN << 3) |
-           (TLE9201SG.SEN << 2) |
-           (TLE9201SG.SDIR << 1) |
-           TLE9201SG.SPWM;
+    return command | GET_BITS(TLE9201SG.control, TLE9201SG_CTRL_gm);
+}
+
+/**
+ * @brief Attributes a byte returned by the TLE9201SG to the command that caused it.
+ *
+ * The TLE9201SG answers a command during the following frame, so the byte received
+ * with `sent` belongs to the command of the previous frame (`TLE9201SG.pending`).
+ * SPI0 completion callback, runs in the SPI0 interrupt.
+ *
+ * @param sent The frame that was sent.
+ * @param received The byte returned with it (answer to the previous frame).
+ */
+void TLE9201SG_Response(uint8_t sent, uint8_t received) {
+#ifdef JITTER
+    if (GET_BITS(sent, TLE9201SG_CMD_gm) == WR_CTRL_RD_DIA && GET_BIT(sent, 0)) {
+        JITTER_Mark(); // SPWM on edge reached the TLE9201SG, a new period starts
+    }
+#endif
+    switch (TLE9201SG.pending) {
+        case RD_DIA:
+        case RES_DIA:
+        case WR_CTRL_RD_DIA:
+            if (received != TLE9201SG.diag) { // Only a change needs any work
+                uint8_t previous = TLE9201SG.diag;
+                TLE9201SG.diag = received;
+                TLE9201SG.dirty = 1;
+                if (TLE9201SG.hook) {
+                    TLE9201SG.hook(previous, received);
+                }
+            }
+            break;
+        case RD_REV:
+            TLE9201SG.revision = received;
+            break;
+        case RD_CTRL:
+        case WR_CTRL:
+            TLE9201SG.control = received; // Control bits are views of this byte
+            break;
+        default: // First frame after init, nothing to attribute
+            break;
+    }
+    TLE9201SG.pending = GET_BITS(sent, TLE9201SG_CMD_gm);
+}
+
+/**
+ * @brief Queues a frame for the TLE9201SG and tracks its response.
+ *
+ * @param frame Complete frame (command and data bits) to send.
+ * @return 1 if queued, 0 if the SPI0 queue is full.
+ */
+uint8_t TLE9201SG_Send(uint8_t frame) {
+    return SPI0_Enqueue(frame, TLE9201SG_Response);
+}
+
+/**
+ * @brief Calculates the SPI-mode PWM on/off times.
+ *
+ * Uses only the cached clock tree and the driver configuration, no peripheral
+ * registers, so the timing math can be checked without the hardware. The on/off
+ * times are TCB0 compare values stored in `TLE9201SG.on` and `TLE9201SG.off`.
+ * Any on phase is at least one frame long, so a zero duty cannot be timed; it
+ * sets `TLE9201SG.hold` instead and SPWM stays off while the period keeps running.
+ *
+ * @param duty_cycle Duty cycle as a fraction of 65536 (0xFFFF is 100%).
+ * @return TCB0 clock selection the on/off times are calculated for.
+ */
+uint8_t TLE9201SG_SPI_Timing(uint16_t duty_cycle) {
+    uint8_t clksel = TCB_CLKSEL_DIV1_gc;
+    uint8_t ticks_us = CLOCK_Tree.per_us; // TCB0 runs from CLK_PER
+    uint32_t sig_period = CLOCK_Tree.per / TLE9201SG.pwm_freq; // Period in TCB0 ticks for required frequency
+    if (sig_period > 0xFFFF) { // Too slow for a 16-bit period, halve the timer clock
+        ticks_us /= 2;
+        sig_period /= 2;
+        clksel = TCB_CLKSEL_DIV2_gc;
+    }
+    if (sig_period > 0xFFFF) {
+        sig_period = 0xFFFF; // Slowest period TCB0 can do
+    }
+
+    // Shortest phase must still fit one SPI frame and the edge interrupt
+    uint16_t sig_min = ticks_us * TLE9201SG_SPI_TIME_COMPENSATION;
+    if (sig_min > sig_period / 2) {
+        sig_min = sig_period / 2; // Frequency too high to honour it, keep the duty centred
+    }
+    uint16_t sig_on = (sig_period * duty_cycle) >> 16; // Calculate PWM duty cycle
+    if (sig_on < sig_min) {
+        sig_on = sig_min;
+    }
+    if (sig_on > sig_period - sig_min) {
+        sig_on = sig_period - sig_min;
+    }
+
+    TLE9201SG.off = sig_period - sig_on - 1; // PWM off time (TCB0 counts CCMP + 1 ticks)
+    TLE9201SG.on = sig_on - 1;               // PWM on time
+    TLE9201SG.hold = !duty_cycle;            // Shortest on-time is not zero, keep SPWM off instead
+    return clksel;
 }
 
 /**
@@ -56,7 +179,8 @@ uint8_t TLE9201SG_Write(uint8_t command) {
  *
  * This function stops any ongoing SPI communication, initializes the SPI module, 
  * and sets up the TLE9201SG for SPI mode operation. It also calculates the virtual 
- * PWM signal timing for simulating PWM behavior through SPI.
+ * PWM signal timing for simulating PWM behavior through SPI (see TLE9201SG_SPI_Timing()).
+ * TCB0 switches the SPWM bit at every compare match.
  */
 void TLE9201SG_SPI_Mode_Init() {
     SPI0_Stop(); // Ensure SPI0 module is stopped
@@ -67,23 +191,14 @@ void TLE9201SG_SPI_Mode_Init() {
     TLE9201SG.OLDIS = 0;
     TLE9201SG.SEN = 0;
 
-    uint8_t init_cmd[3] = {TLE9201SG_Write(WR_CTRL), RD_REV, 0};
-    for (uint8_t i = 0; i < 3; i++) {
-        init_cmd[i] = SPI0_Exchange_Data(init_cmd[i]);
-    }
-
-    // Update control and revision values
-    TLE9201SG.control = init_cmd[1];
-    TLE9201SG.revision = init_cmd[2];
-    TLE9201SG_Sort_Control();
+    // Control value comes back with RD_REV, revision with the first PWM frame
+    TLE9201SG.pending = TLE9201SG_CMD_NONE;
+    TLE9201SG_Send(TLE9201SG_Write(WR_CTRL));
+    TLE9201SG_Send(RD_REV);
+    SPI0_Flush();
 
     // PWM signal timing calculations
-    float sig_calc = 1.0f / CLOCK_read() * 4.0f; // Calculate the time base based on the current main clock
-    float sig_period = (1.0f / TLE9201SG.pwm_freq) - TLE9201SG_SPI_TIME_COMPENSATION; // Calculate period for required frequency
-    float sig_on = (TLE9201SG.duty_cycle / 100.0f) * sig_period; // Calculate PWM duty cycle
-
-    TLE9201SG.off = (sig_period - sig_on) / sig_calc; // Calculate PWM off time
-    TLE9201SG.on = sig_on / sig_calc;                // Calculate PWM on time
+    TCB0_init(TLE9201SG_SPI_Timing(TLE9201SG.duty_cycle));
 }
 
 /**
@@ -91,12 +206,21 @@ void TLE9201SG_SPI_Mode_Init() {
  *
  * This function initializes the hardware components required for the PWM/DIR 
  * control mode, including the Phase-Locked Loop (PLL), Timer/Counter D (TCD), 
- * and the PWM generation module.
+ * and the PWM generation module. The TCD clock source, prescalers and waveform
+ * mode are planned for the most duty steps at `TLE9201SG.pwm_freq`.
  */
 void TLE9201SG_PWM_Mode_Init() {
+    TCD0_PLAN plan;
+
     PLL_init();  // Initialize Phase-Locked Loop (PLL)
     TCD0_init(); // Initialize Timer/Counter D (TCD)
+    PWM_plan(TLE9201SG.pwm_freq, TLE9201SG_PWM_RESOLUTION, &plan);
+    PWM_apply(&plan);
     PWM_init(TLE9201SG.pwm_freq, TLE9201SG.duty_cycle);
+#ifdef CURRENT_CONTROL
+    CURRENT_init(); // Sample the motor current once per PWM period
+    CURRENT_ON();
+#endif
 }
 
 /**
@@ -111,6 +235,11 @@ void TLE9201SG_PWM_Mode_Init() {
  */
 void TLE9201SG_Mode_init(uint8_t mode) {
     TLE9201SG.mode = mode;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { // Diagnosis of the previous mode no longer applies
+        TLE9201SG.diag = 0;
+        TLE9201SG.Fault = 0;
+        TLE9201SG.dirty = 0;
+    }
 
     if (mode) {
         TLE9201SG_SPI_Mode_Init(); // SPI mode initialization
@@ -120,14 +249,22 @@ void TLE9201SG_Mode_init(uint8_t mode) {
 }
 
 /**
- * @brief Turns off the TLE9201SG outputs.
+ * @brief Turns off the TLE9201SG outputs at once.
  * 
  * This function disables the TLE9201SG outputs, either via SPI or by controlling 
  * the hardware pin directly, depending on the current control mode.
  */
-void TLE9201SG_STOP() {
+void TLE9201SG_OFF() {
     if (TLE9201SG.mode) { // SPI mode
-        TLE9201SG.SEN = 0; // Disable outputs
+        if (TLE9201SG.SEN) {
+            TCB0_OFF(); // Stop the PWM edge timer
+#ifdef JITTER
+            JITTER_Stop();
+#endif
+            TLE9201SG.SEN = 0; // Disable outputs
+            TLE9201SG.SPWM = 0;
+            TLE9201SG_Send(TLE9201SG_Write(WR_CTRL_RD_DIA));
+        }
     } else { // PWM/DIR mode
         TCD0_OFF(); // Turn off the timer/counter
         PORTD.OUTSET = PIN6_bm; // Set the pin to disable outputs
@@ -135,13 +272,165 @@ void TLE9201SG_STOP() {
 }
 
 /**
- * @brief Sets the direction of the TLE9201SG motor driver.
+ * @brief Stops the motor driver outputs.
+ *
+ * The duty is ramped down to zero at the braking slew rate and the outputs are
+ * switched off by the control tick once it gets there (see RAMP_Brake()). With
+ * braking disabled the outputs are switched off at once. Never blocks.
+ */
+void TLE9201SG_STOP() {
+    if (!RAMP_Brake()) {
+        TLE9201SG_OFF();
+        RAMP_Reset();
+    }
+}
+
+/**
+ * @brief Tells whether the driver outputs are running.
+ *
+ * @return Non-zero if SPI-mode PWM is enabled or TCD0 runs in PWM/DIR mode.
+ */
+uint8_t TLE9201SG_Running() {
+    return TLE9201SG.mode ? TLE9201SG.SEN : (TCD0.CTRLA & TCD_ENABLE_bm);
+}
+
+/**
+ * @brief Drives the outputs with a duty cycle.
+ *
+ * In SPI mode the new on/off times are used from the next TCB0 edge; in PWM/DIR
+ * mode the TCD compare values are staged for the end of the TCD cycle.
+ *
+ * @param duty_cycle Duty cycle as a fraction of 65536 (0xFFFF is 100%).
+ * @return 1 if applied, 0 if a previous PWM update is still pending.
+ */
+uint8_t TLE9201SG_Drive(uint16_t duty_cycle) {
+    if (TLE9201SG.mode) { // SPI mode
+        TLE9201SG_SPI_Timing(duty_cycle);
+        return 1;
+    }
+    return PWM_set_duty(duty_cycle); // PWM/DIR mode
+}
+
+/**
+ * @brief Applies a duty cycle from the ramp generator.
+ *
+ * While the speed controller or the current regulator runs, the duty only limits
+ * what it may apply; otherwise it drives the outputs.
+ * Called by the ramp generator from the control tick.
+ *
+ * @param duty_cycle Duty cycle as a fraction of 65536 (0xFFFF is 100%).
+ * @return 1 if applied, 0 if a previous PWM update is still pending.
+ */
+uint8_t TLE9201SG_Apply_Duty(uint16_t duty_cycle) {
+    if (PID_Speed.enabled) { // Speed controller sets the duty
+        PID_Speed.limit = duty_cycle;
+        return 1;
+    }
+#ifdef CURRENT_CONTROL
+    if (!TLE9201SG.mode && CURRENT_Loop.enabled) { // Current regulator sets the duty
+        CURRENT_Loop.limit = duty_cycle;
+        return 1;
+    }
+#endif
+    return TLE9201SG_Drive(duty_cycle);
+}
+
+/**
+ * @brief Changes the configured duty cycle.
+ *
+ * While the outputs run the duty ramps to the new value at the configured slew
+ * rate; otherwise it is used by the next TLE9201SG_START().
+ *
+ * @param duty_cycle Duty cycle as a fraction of 65536 (0xFFFF is 100%).
+ */
+void TLE9201SG_Set_Duty(uint16_t duty_cycle) {
+    TLE9201SG.duty_cycle = duty_cycle;
+    if (TLE9201SG_Running() && RAMP.state != RAMP_BRAKE) {
+        RAMP_set_target(duty_cycle);
+    }
+}
+
+/**
+ * @brief Changes the PWM frequency.
+ *
+ * While the outputs are off the driver is initialized again for the new frequency,
+ * so in PWM/DIR mode the TCD0 clock and prescalers are planned for it. While running
+ * in PWM/DIR mode the period changes at the end of the TCD cycle with the current
+ * prescalers. The SPI-mode edge timer is only set up while stopped.
+ *
+ * @param freq PWM frequency in Hz.
+ * @return 1 if applied, 0 if it cannot be applied now (SPI-mode outputs running,
+ *         a PWM update pending or the period out of range of the running TCD0).
+ */
+uint8_t TLE9201SG_Set_Freq(uint16_t freq) {
+    if (!freq) {
+        return 0;
+    }
+    if (!TLE9201SG_Running()) {
+        TLE9201SG.pwm_freq = freq;
+        TLE9201SG_Mode_init(TLE9201SG.mode);
+#ifdef JITTER
+        JITTER_Reset(); // New nominal period
+#endif
+        return 1;
+    }
+    if (TLE9201SG.mode || !PWM_set_freq(freq)) {
+        return 0;
+    }
+    TLE9201SG.pwm_freq = freq;
+#ifdef JITTER
+    JITTER_Reset(); // New nominal period
+#endif
+    return 1;
+}
+
+/**
+ * @brief Switches between SPI mode and PWM/DIR mode.
+ *
+ * Only while the outputs are off. Leaving SPI mode hands the outputs back to the
+ * PWM/DIR pins (SIN cleared); entering it releases the DIS pin so SEN controls
+ * the outputs.
+ *
+ * @param mode TLE9201SG_MODE_SPI or TLE9201SG_MODE_PWMDIR.
+ * @return 1 if switched, 0 if the outputs are running.
+ */
+uint8_t TLE9201SG_Set_Mode(uint8_t mode) {
+    if (TLE9201SG_Running() || RAMP.state != RAMP_IDLE) {
+        return 0;
+    }
+    if (TLE9201SG.mode && !mode) { // SPI -> PWM/DIR
+        TCB0_OFF();
+        TLE9201SG.SIN = 0; // Inputs take over
+        TLE9201SG_Send(TLE9201SG_Write(WR_CTRL));
+        SPI0_Flush();
+        PORTD.OUTSET = PIN6_bm; // Outputs stay off until TLE9201SG_START()
+    } else if (!TLE9201SG.mode && mode) { // PWM/DIR -> SPI
+        TCD0_OFF();
+        // PA5 is SPI0 MISO now, disconnect the fault input (TCD0_init() routes it again)
+        EVSYS.USERTCD0INPUTA = 0;
+        TCD0.INTCTRL &= ~TCD_TRIGA_bm;
+        TCD0.INTFLAGS = TCD_TRIGA_bm;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            if (TLE9201SG.latched && TLE9201SG.latch_hook) {
+                TLE9201SG.latch_hook(0);
+            }
+            TLE9201SG.latched = 0;
+        }
+        PORTD.OUTCLR = PIN6_bm; // SEN controls the outputs
+    }
+    TLE9201SG_Mode_init(mode);
+    return 1;
+}
+
+/**
+ * @brief Applies a direction to the TLE9201SG motor driver at once.
  * @param direction The desired direction (0 or 1).
  * 
  * This function sets the direction of the motor driver outputs, either via SPI or 
  * by controlling the hardware pin directly, depending on the current control mode.
+ * Called by the ramp generator once the duty is zero.
  */
-void TLE9201SG_DIR(uint8_t direction) {
+void TLE9201SG_Apply_Dir(uint8_t direction) {
 	if (TLE9201SG.mode) { // SPI mode
 		TLE9201SG.SDIR = direction;
 		} else { // PWM/DIR mode
@@ -150,28 +439,147 @@ void TLE9201SG_DIR(uint8_t direction) {
 	}
 }
 
+/**
+ * @brief Holds the bridge off through a direction change (PWM/DIR mode).
+ *
+ * At zero duty double slope still emits a one-count pulse every period, so the
+ * DIS pin is held high while the dead time passes. SPI mode needs nothing here:
+ * zero duty already keeps SPWM off.
+ *
+ * @param hold 1 to disable the outputs, 0 to enable them again (unless a fault is latched).
+ */
+void TLE9201SG_Hold(uint8_t hold) {
+    if (TLE9201SG.mode) {
+        return;
+    }
+    if (hold) {
+        PORTD.OUTSET = PIN6_bm; // Set the pin to disable outputs
+    } else if (!TLE9201SG.latched && (TCD0.CTRLA & TCD_ENABLE_bm)) {
+        PORTD.OUTCLR = PIN6_bm; // Clear the pin to enable outputs
+    }
+}
+
+/**
+ * @brief Sets the direction of the TLE9201SG motor driver.
+ * @param direction The desired direction (0 or 1).
+ *
+ * While the outputs are off the direction changes at once. While they run, a
+ * change is handed to the ramp generator: duty ramps down to zero, the dead time
+ * passes, the direction flips and the duty ramps back up. Never blocks.
+ */
+void TLE9201SG_DIR(uint8_t direction) {
+    uint8_t current = TLE9201SG.mode ? TLE9201SG.SDIR : GET_BIT(PORTD.OUT, PIN5_bp);
+    if (RAMP.reverse || (TLE9201SG_Running() && direction != current)) {
+        RAMP_Reverse(direction);
+    } else {
+        TLE9201SG_Apply_Dir(direction);
+    }
+}
+
+/**
+ * @brief Switches the SPWM bit at every TCB0 compare match (SPI mode).
+ *
+ * The next phase length is loaded into CCMP before the frame carrying the new
+ * SPWM state is queued, so the PWM period does not depend on main loop load.
+ * At zero duty (`TLE9201SG.hold`) the on phase keeps SPWM off; the frames still
+ * poll the diagnosis.
+ */
+ISR(TCB0_INT_vect) {
+    TCB0.INTFLAGS = TCB_CAPT_bm;
+
+    if (TLE9201SG.phase) { // On phase ended
+        TLE9201SG.phase = 0;
+        TLE9201SG.SPWM = 0;
+        TCB0.CCMP = TLE9201SG.off;
+        TLE9201SG_Send(TLE9201SG_Write(WR_CTRL_RD_DIA));
+    } else { // Off phase ended
+        TLE9201SG.phase = 1;
+        TLE9201SG.SPWM = !TLE9201SG.hold; // Zero duty keeps the bridge off
+        TCB0.CCMP = TLE9201SG.on;
+        TLE9201SG_Send(TLE9201SG_Write(WR_CTRL_RD_DIA)); // Diagnosis of the previous frame comes back, TLE9201SG_Response() sorts it out
+    }
+}
+
 /**
  * @brief Starts the motor driver outputs.
  * 
- * This function starts the motor driver outputs, either by toggling the SPWM bit
- * via SPI or by enabling the timer/counter in PWM/DIR mode.
+ * This function starts the motor driver outputs, either by starting the TCB0
+ * edge timer that toggles the SPWM bit via SPI or by enabling the timer/counter
+ * in PWM/DIR mode. Outputs start at zero duty and ramp up to `TLE9201SG.duty_cycle`
+ * in the background. Calling it while running (or braking) ramps back to the
+ * configured duty from where it is.
  */
 void TLE9201SG_START() {
+    PROFILE_BEGIN(PROFILE_START);
     if (TLE9201SG.mode) { // SPI mode imitating pwm...
-		TLE9201SG.SEN = 1; // Enable outputs
-        TLE9201SG.SPWM = 1;
-		TLE9201SG.diag = SPI0_Exchange_Data(TLE9201SG_Write(WR_CTRL_RD_DIA)); //returning not curent value but value from the past... I hate SPI on TLE9201SG!!!
-        _delay_loop_2(TLE9201SG.on); // Wait for the on-time duration
-		TLE9201SG_Sort_Diagnosis(); //but spi have good diagnosis...
-        TLE9201SG.SPWM = 0;
-	   SPI0_Exchange_Data(TLE9201SG_Write(WR_CTRL_RD_DIA)); //same...
-        _delay_loop_2(TLE9201SG.off); // Wait for the off-time duration
-
+        if (!TLE9201SG.SEN) {
+            RAMP_Reset();
+            TLE9201SG_Apply_Duty(0); // Soft start from zero duty, SPWM held off
+            TLE9201SG.SEN = 1; // Enable outputs
+            TLE9201SG.phase = 1;
+            TLE9201SG.SPWM = !TLE9201SG.hold;
+            TCB0.CCMP = TLE9201SG.on; // First phase is the on-time
+            TLE9201SG_Send(TLE9201SG_Write(WR_CTRL_RD_DIA));
+            TCB0_ON(); // Edges are scheduled by the timer from now on
+        }
     } else { // PWM/DIR mode
+        if (!(TCD0.CTRLA & TCD_ENABLE_bm) || TLE9201SG.latched) {
+            RAMP_Reset();
+            TLE9201SG_Apply_Duty(0); // Soft start from zero duty
+        }
+        if (TLE9201SG.latched && !TLE9201SG_Fault_Recover()) {
+            PROFILE_END(PROFILE_START);
+            return; // Fault still active, keep outputs off
+        }
         TCD0_ON(); // Enable the timer/counter for easy pwm generation 
-		PORTD.OUTCLR = PIN6_bm; // Clear the pin to enable outputs
-		if(PORTA.IN & PIN5_bm)
-		TLE9201SG.Fault = (PORTA.IN & PIN5_bm) ?  1 : 0; //checking fault flag only...
+		TLE9201SG_Hold(RAMP.state == RAMP_DEADTIME); // Enable outputs, unless a dead time is in progress
+    }
+    RAMP_set_target(TLE9201SG.duty_cycle);
+    PROFILE_END(PROFILE_START);
+}
+
+/**
+ * @brief TCD0 input A interrupt: the TLE9201SG raised its fault flag (PWM/DIR mode).
+ *
+ * TCD0 has already forced the PWM output low in hardware; this latches the fault
+ * and also disables the bridge with the DIS pin. Ignored in SPI mode, where PA5 is
+ * SPI0 MISO.
+ */
+ISR(TCD0_TRIG_vect) {
+    TCD0.INTFLAGS = TCD_TRIGA_bm;
+    if (TLE9201SG.mode) {
+        return; // MISO traffic, not a fault
+    }
+    if (!TLE9201SG.latched && TLE9201SG.latch_hook) {
+        TLE9201SG.latch_hook(1);
+    }
+    TLE9201SG.latched = 1;
+    PORTD.OUTSET = PIN6_bm; // Set the pin to disable outputs
+}
+
+/**
+ * @brief Recovers from a latched fault in PWM/DIR mode.
+ *
+ * Restarts TCD0 from its fault wait state once the fault flag (PA5) is low again and
+ * re-enables the outputs if the timer is running.
+ *
+ * @return 1 if the fault was cleared, 0 if the fault flag is still active.
+ */
+uint8_t TLE9201SG_Fault_Recover() {
+    if (PORTA.IN & PIN5_bm) {
+        return 0; // Fault still present
+    }
+    while (!(TCD0.STATUS & TCD_CMDRDY_bm)); // Wait until TCD accepts a command
+    TCD0.CTRLE = TCD_RESTART_bm; // Leave the fault wait state
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { // A new trip must not slip in between
+        if (TLE9201SG.latched && TLE9201SG.latch_hook) {
+            TLE9201SG.latch_hook(0);
+        }
+        TLE9201SG.latched = 0;
+    }
+    if (TCD0.CTRLA & TCD_ENABLE_bm) {
+        PORTD.OUTCLR = PIN6_bm; // Clear the pin to enable outputs
     }
+    return 1;
 }
 
@@ -23,8 +23,7 @@
  * @param bit The bit position to extract (0 for LSB, increasing towards MSB).
  * @return The value of the specified bit (0 or 1).
  *
- * @note Used in functions like TLE9201SG_Sort_Diagnosis() and TLE9201SG_Sort_Control() 
- *       to extract individual data bits for processing.
+ * @note Used to read single port bits, e.g. the DIR pin in TLE9201SG_DIR().
  */
 #define GET_BIT(value, bit) (((value) >> (bit)) & 0x01)
 
@@ -38,7 +37,7 @@
  * @param mask A mask specifying which bits to extract (1 for bits of interest, 0 otherwise).
  * @return The value of the bits of interest, with all other bits cleared.
  *
- * @note Used in functions like TLE9201SG_Sort_Diagnosis() to extract groups of data bits.
+ * @note Used to extract groups of data bits, e.g. the command bits of an SPI frame.
  */
 #define GET_BITS(value, mask) ((value) & (mask))
 
@@ -49,8 +48,8 @@
 /** @brief TLE9201SG mode: PWM-DIR control */
 #define TLE9201SG_MODE_PWMDIR 0
 
-/** @brief SPI time compensation for sending and receiving data (16 s). */
-#define TLE9201SG_SPI_TIME_COMPENSATION 0.000014 
+/** @brief SPI time compensation in s: shortest SPI-mode PWM phase, fits one frame and the edge interrupt. */
+#define TLE9201SG_SPI_TIME_COMPENSATION 14
 
 /** @brief Command to read the Diagnosis Register. */
 #define RD_DIA 0b00000000
@@ -70,35 +69,102 @@
 /** @brief Command to write Control values and read Diagnosis Register values. */
 #define WR_CTRL_RD_DIA 0b11000000
 
+/** @brief Minimum PWM duty steps requested from PWM_plan() in PWM/DIR mode. */
+#define TLE9201SG_PWM_RESOLUTION 1000
+
+/** @brief Mask of the command bits in an SPI frame. */
+#define TLE9201SG_CMD_gm 0b11100000
+
+/** @brief No command pending (first frame after SPI mode initialization). */
+#define TLE9201SG_CMD_NONE 0xFF
+
+/** @brief Mask of the control bits (OLDIS, SIN, SEN, SDIR, SPWM) in an SPI frame. */
+#define TLE9201SG_CTRL_gm 0b00011111
+
+/** @brief DIA value when no diagnosis error is reported. */
+#define TLE9201SG_DIA_OK 0x0F
+
+/** @brief Mask of the DIA bits in the diagnosis byte. */
+#define TLE9201SG_DIA_gm 0x0F
+
+/** @brief Current limit bit (CL) in the diagnosis byte. */
+#define TLE9201SG_CL_bm (1 << 4)
+
+/** @brief Thermal warning bit (TV) in the diagnosis byte. */
+#define TLE9201SG_TV_bm (1 << 5)
+
+/** @brief Over-temperature bit (OT) in the diagnosis byte. */
+#define TLE9201SG_OT_bm (1 << 6)
+
+/**
+ * @brief Diagnosis change hook.
+ *
+ * Called from the SPI0 interrupt when a received diagnosis byte differs from the
+ * previous one. Keep it short.
+ *
+ * @param previous The previous diagnosis byte.
+ * @param diag The new diagnosis byte.
+ */
+typedef void (*TLE9201SG_Diag_Hook)(uint8_t previous, uint8_t diag);
+
+/**
+ * @brief Fault latch hook.
+ *
+ * Called from the TCD0 fault interrupt when the latch trips and from
+ * TLE9201SG_Fault_Recover() when it is cleared (PWM/DIR mode).
+ *
+ * @param latched 1 when the latch tripped, 0 when it recovered.
+ */
+typedef void (*TLE9201SG_Latch_Hook)(uint8_t latched);
+
 /**
  * @struct TLE9201SG_DATA
  * @brief Structure for storing TLE9201SG configuration and status.
+ *
+ * @details The status and control bits are bitfield views laid over the raw `diag`
+ *          and `control` bytes (bit 0 first), so a received byte is decoded by storing
+ *          it and a control frame is built from `control` in one operation.
  */
 typedef struct {
     uint8_t revision;    ///< Device revision number.
-    uint8_t diag;        ///< Diagnosis register value.
-    uint8_t control;     ///< Control register value.
-    uint8_t EN;          ///< Enable status.
-    uint8_t OT;          ///< Over-temperature status.
-    uint8_t TV;          ///< Thermal warning status.
-    uint8_t CL;          ///< Current limit status.
-    uint8_t DIA;         ///< Diagnosis error status.
-    uint8_t Fault;       ///< Fault status.
-    uint8_t CMD;         ///< Last command sent to the device.
-    uint8_t OLDIS;       ///< Output disable status.
-    uint8_t SIN;         ///< SPI control.
-    uint8_t SEN;         ///< SPI on and off.
-    uint8_t SDIR;        ///< Direction status.
-    uint8_t SPWM;        ///< PWM status.
+    union {
+        uint8_t diag;    ///< Diagnosis register value.
+        struct {
+            uint8_t DIA : 4; ///< Diagnosis error status (bits 3-0).
+            uint8_t CL : 1;  ///< Current limit status (bit 4).
+            uint8_t TV : 1;  ///< Thermal warning status (bit 5).
+            uint8_t OT : 1;  ///< Over-temperature status (bit 6).
+            uint8_t EN : 1;  ///< Enable status (bit 7).
+        };
+    };
+    union {
+        uint8_t control; ///< Control register value.
+        struct {
+            uint8_t SPWM : 1;  ///< PWM status (bit 0).
+            uint8_t SDIR : 1;  ///< Direction status (bit 1).
+            uint8_t SEN : 1;   ///< SPI on and off (bit 2).
+            uint8_t SIN : 1;   ///< SPI control (bit 3).
+            uint8_t OLDIS : 1; ///< Output disable status (bit 4).
+            uint8_t CMD : 3;   ///< Last command sent to the device (bits 7-5).
+        };
+    };
+    uint8_t Fault;       ///< SPI-mode fault status (DIA value), up to date after TLE9201SG_Fault_Status().
+    uint8_t dirty;       ///< 1 when `diag` changed and Fault is not derived from it yet.
+    uint8_t latched;     ///< 1 while TCD0 holds a fault raised by the fault flag (PWM/DIR mode).
+    TLE9201SG_Latch_Hook latch_hook; ///< Called when `latched` changes (NULL if not used).
+    TLE9201SG_Diag_Hook hook; ///< Called when the diagnosis byte changes (NULL if not used).
+    uint8_t pending;     ///< Command answered by the next received byte.
     uint8_t back;        ///< Backup register.
     uint8_t mode;        ///< Current operating mode (SPI or PWM-DIR).
     uint16_t pwm_freq;   ///< PWM frequency in Hz.
-    float duty_cycle;    ///< Duty cycle percentage (0-100%).
-    uint16_t on;         ///< PWM on time using `_delay_loop2()`.
-    uint16_t off;        ///< PWM off time using `_delay_loop2()`.
+    uint16_t duty_cycle; ///< Duty cycle as a fraction of 65536 (0xFFFF is 100%).
+    uint16_t on;         ///< PWM on time as TCB0 compare value.
+    uint16_t off;        ///< PWM off time as TCB0 compare value.
+    uint8_t phase;       ///< 1 while TCB0 times the on phase (SPI mode).
+    uint8_t hold;        ///< 1 while the duty is zero: SPWM stays off through the on phases (SPI mode).
 } TLE9201SG_DATA;
 
-/** @brief Global variable for storing TLE9201SG data and configuration. */
-extern TLE9201SG_DATA TLE9201SG;
+/** @brief Global variable for storing TLE9201SG data and configuration (shared with the SPI and timer interrupts). */
+extern volatile TLE9201SG_DATA TLE9201SG;
 
 #endif /* TLE9201SG_H_ */
@@ -0,0 +1,112 @@
+/**
+ * @file TLE9201SGSim.c
+ * @brief Behavioral model of the TLE9201SG SPI interface.
+ *
+ * @details Stands in for the chip when TLE9201SG_SIMULATION is defined, so SPI mode
+ *          can be run without hardware: the SPI0 engine hands every frame to
+ *          TLE9201SG_Sim_Exchange(). The counters in TLE9201SG_Sim show how many frames
+ *          each control cycle costs.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+
+#ifdef TLE9201SG_SIMULATION
+
+#include "TLE9201SGSimVar.h"
+
+/**
+ * @brief Builds the diagnosis register of the model.
+ *
+ * @return EN bit from the control register, latched flags and diagnosis code.
+ */
+uint8_t TLE9201SG_Sim_Diagnosis() {
+    uint8_t diag = TLE9201SG_Sim.flags | TLE9201SG_Sim.dia;
+    if (TLE9201SG_Sim.control & TLE9201SG_SIM_SEN_bm) {
+        diag |= TLE9201SG_SIM_EN_bm;
+    }
+    return diag;
+}
+
+/**
+ * @brief Resets the model to its power-up state and clears the frame counters.
+ */
+void TLE9201SG_Sim_Reset() {
+    TLE9201SG_Sim.control = 0x00;
+    TLE9201SG_Sim.flags = 0x00;
+    TLE9201SG_Sim.dia = TLE9201SG_SIM_DIA_OK;
+    TLE9201SG_Sim.out = TLE9201SG_Sim_Diagnosis();
+    for (uint8_t i = 0; i < 8; i++) {
+        TLE9201SG_Sim.frames[i] = 0;
+    }
+    TLE9201SG_Sim.total = 0;
+}
+
+/**
+ * @brief Exchanges one frame with the model.
+ *
+ * @details Returns the answer prepared by the previous frame and prepares the answer
+ *          to this one, like the shift register of the real device:
+ * - RD_DIA, WR_CTRL_RD_DIA: diagnosis register.
+ * - RES_DIA: diagnosis register, then latched flags and code are cleared.
+ * - RD_REV: revision number.
+ * - RD_CTRL: control register.
+ * - WR_CTRL: control register after the write.
+ *
+ * @param frame Frame sent to the model.
+ * @return Answer to the previous frame.
+ */
+uint8_t TLE9201SG_Sim_Exchange(uint8_t frame) {
+    uint8_t answer = TLE9201SG_Sim.out;
+    uint8_t command = GET_BITS(frame, TLE9201SG_CMD_gm);
+
+    TLE9201SG_Sim.frames[command >> 5]++;
+    TLE9201SG_Sim.total++;
+
+    switch (command) {
+        case RD_DIA:
+            TLE9201SG_Sim.out = TLE9201SG_Sim_Diagnosis();
+            break;
+        case RES_DIA:
+            TLE9201SG_Sim.out = TLE9201SG_Sim_Diagnosis();
+            TLE9201SG_Sim.flags = 0x00;
+            TLE9201SG_Sim.dia = TLE9201SG_SIM_DIA_OK;
+            break;
+        case RD_REV:
+            TLE9201SG_Sim.out = TLE9201SG_SIM_REVISION;
+            break;
+        case RD_CTRL:
+            TLE9201SG_Sim.out = TLE9201SG_Sim.control;
+            break;
+        case WR_CTRL:
+            TLE9201SG_Sim.control = frame;
+            TLE9201SG_Sim.out = TLE9201SG_Sim.control;
+            break;
+        case WR_CTRL_RD_DIA:
+            TLE9201SG_Sim.control = frame;
+            TLE9201SG_Sim.out = TLE9201SG_Sim_Diagnosis();
+            break;
+        default: // Undefined command, answer with the diagnosis register
+            TLE9201SG_Sim.out = TLE9201SG_Sim_Diagnosis();
+            break;
+    }
+    return answer;
+}
+
+/**
+ * @brief Injects a fault into the model.
+ *
+ * @details The flags and code are latched like on the real device and reported by
+ *          every diagnosis read until RES_DIA clears them.
+ *
+ * @param flags Any of TLE9201SG_SIM_OT_bm, TLE9201SG_SIM_TV_bm, TLE9201SG_SIM_CL_bm.
+ * @param dia Diagnosis code (TLE9201SG_SIM_DIA_OK for none).
+ */
+void TLE9201SG_Sim_Inject(uint8_t flags, uint8_t dia) {
+    TLE9201SG_Sim.flags |= GET_BITS(flags, TLE9201SG_SIM_OT_bm | TLE9201SG_SIM_TV_bm | TLE9201SG_SIM_CL_bm);
+    TLE9201SG_Sim.dia = GET_BITS(dia, 0x0F);
+}
+
+#endif /* TLE9201SG_SIMULATION */
@@ -0,0 +1,54 @@
+/**
+ * @file TLE9201SGSim.h
+ * @brief Header file for the behavioral TLE9201SG SPI model.
+ *
+ * @details The model answers the RD_DIA, RES_DIA, RD_REV, RD_CTRL, WR_CTRL and
+ *          WR_CTRL_RD_DIA frames one frame late, like the real device, supports
+ *          fault injection and counts frames per command. It is compiled in only
+ *          when TLE9201SG_SIMULATION is defined (see Settings.h).
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef TLE9201SGSIM_H_
+#define TLE9201SGSIM_H_
+
+/** @brief Diagnosis bit: outputs enabled. */
+#define TLE9201SG_SIM_EN_bm 0b10000000
+
+/** @brief Diagnosis bit: over-temperature. */
+#define TLE9201SG_SIM_OT_bm 0b01000000
+
+/** @brief Diagnosis bit: temperature warning. */
+#define TLE9201SG_SIM_TV_bm 0b00100000
+
+/** @brief Diagnosis bit: current limit reached. */
+#define TLE9201SG_SIM_CL_bm 0b00010000
+
+/** @brief Diagnosis code: no failure. */
+#define TLE9201SG_SIM_DIA_OK 0x0F
+
+/** @brief Control register bit: outputs enabled in SPI mode (SEN). */
+#define TLE9201SG_SIM_SEN_bm 0b00000100
+
+/** @brief Revision number reported by the model. */
+#define TLE9201SG_SIM_REVISION 0x22
+
+/**
+ * @struct TLE9201SG_SIM_DATA
+ * @brief Structure for storing the TLE9201SG model state and frame counters.
+ */
+typedef struct {
+    uint8_t control;    ///< Control register (last written value).
+    uint8_t flags;      ///< Latched OT/TV/CL flags, cleared by RES_DIA.
+    uint8_t dia;        ///< Latched diagnosis code, reset to TLE9201SG_SIM_DIA_OK by RES_DIA.
+    uint8_t out;        ///< Answer shifted out with the next frame.
+    uint16_t frames[8]; ///< Frames received per command (indexed by command bits 7-5).
+    uint16_t total;     ///< Frames received in total.
+} TLE9201SG_SIM_DATA;
+
+/** @brief Global variable for storing the TLE9201SG model state. */
+extern TLE9201SG_SIM_DATA TLE9201SG_Sim;
+
+#endif /* TLE9201SGSIM_H_ */
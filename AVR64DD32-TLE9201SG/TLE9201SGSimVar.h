@@ -0,0 +1,27 @@
+/**
+ * @file TLE9201SGSimVar.h
+ * @brief Initialization of the TLE9201SG model global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef TLE9201SGSIMVAR_H_
+#define TLE9201SGSIMVAR_H_
+
+#include "TLE9201SGSim.h" ///< Include the header file for the TLE9201SG_SIM_DATA structure definition.
+
+/**
+ * @brief Global instance of TLE9201SG_SIM_DATA structure.
+ *
+ * @details Power-up state: control register cleared, no failure, nothing counted.
+ */
+TLE9201SG_SIM_DATA TLE9201SG_Sim = {
+    .control = 0x00,              ///< Reset value.
+    .flags = 0x00,                ///< No latched flags.
+    .dia = TLE9201SG_SIM_DIA_OK,  ///< No failure.
+    .out = TLE9201SG_SIM_DIA_OK,  ///< First answer is the diagnosis register.
+    .total = 0                    ///< No frames yet.
+};
+
+#endif /* TLE9201SGSIMVAR_H_ */
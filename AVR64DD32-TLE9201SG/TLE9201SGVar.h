@@ -21,15 +21,17 @@
  *          the TLE9201SG motor driver. These values can be modified during runtime 
  *          based on application requirements.
  */
-TLE9201SG_DATA TLE9201SG = {
+volatile TLE9201SG_DATA TLE9201SG = {
     .revision = 0x00, ///< Default revision value (reset state).
     .diag = 0x00,     ///< Default diagnosis register value (reset state).
+    .control = 0x00,  ///< Outputs enabled (OLDIS), SPI control off (SIN), SPI off (SEN), forward (SDIR), PWM off (SPWM).
     .Fault = 0x00,    ///< No faults detected (reset state).
-    .OLDIS = 0,       ///< Outputs are enabled by default.
-    .SIN = 0,         ///< Default SPI control (disabled).
-    .SEN = 0,         ///< Default SPI (off).
-    .SDIR = 0,        ///< Default direction (neutral or forward).
-    .SPWM = 0,        ///< Default PWM status (disabled).
+    .dirty = 0,       ///< Nothing to derive yet.
+    .latched = 0,     ///< TCD0 fault input not triggered.
+    .hook = 0,        ///< No diagnosis change hook.
+    .latch_hook = 0,  ///< No fault latch hook.
+    .pending = TLE9201SG_CMD_NONE, ///< No response expected yet.
+    .hold = 1,        ///< Zero duty until a duty is applied.
     .mode = TLE9201SG_MODE_PWMDIR ///< Default mode is PWM/DIR.
 };
 
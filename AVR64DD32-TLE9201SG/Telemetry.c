@@ -0,0 +1,139 @@
+/**
+ * @file Telemetry.c
+ * @brief Binary telemetry stream of the driver state over USART1.
+ *
+ * @details TELEMETRY_Task() runs in the main loop. When a frame is due it takes a
+ *          snapshot of the driver state into the back buffer, adds the CRC and COBS
+ *          encodes it there, then hands the buffer to the USART1 interrupt and swaps
+ *          buffers. The interrupt sends straight from the buffer, and the control
+ *          interrupts never copy or format anything for telemetry.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+#include <util/crc16.h>
+#include "TelemetryVar.h"
+
+/**
+ * @brief COBS encodes a block and appends the 0x00 frame delimiter.
+ *
+ * @param data Bytes to encode (up to 254).
+ * @param length Number of bytes.
+ * @param frame Receives the encoded frame, `length` + 2 bytes.
+ * @return Length of the encoded frame including the delimiter.
+ */
+uint8_t TELEMETRY_Encode(const uint8_t *data, uint8_t length, uint8_t *frame) {
+    uint8_t code = 0; // Index of the current code byte
+    uint8_t out = 1;
+
+    for (uint8_t i = 0; i < length; i++) {
+        if (data[i]) {
+            frame[out++] = data[i];
+        } else {
+            frame[code] = out - code; // Distance to the zero
+            code = out++;
+        }
+    }
+    frame[code] = out - code;
+    frame[out++] = 0x00; // Delimiter
+    return out;
+}
+
+/**
+ * @brief Calculates the CRC-16/CCITT-FALSE of a block.
+ *
+ * @param data Bytes to check.
+ * @param length Number of bytes.
+ * @return CRC, sent little endian after the block.
+ */
+uint16_t TELEMETRY_CRC(const uint8_t *data, uint8_t length) {
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < length; i++) {
+        crc = _crc_xmodem_update(crc, data[i]);
+    }
+    return crc;
+}
+
+/**
+ * @brief Takes a snapshot of the driver state and encodes it into the back buffer.
+ */
+void TELEMETRY_Snapshot() {
+    union {
+        TELEMETRY_PAYLOAD payload;
+        uint8_t bytes[sizeof(TELEMETRY_PAYLOAD) + 2];
+    } block;
+    SPEED_SNAPSHOT speed;
+
+    SPEED_Read(&speed);
+    block.payload.type = TELEMETRY_TYPE;
+    block.payload.sequence = TELEMETRY.sequence++;
+    block.payload.fault = TLE9201SG_Fault_Status();
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ///< Fields written by interrupts
+        block.payload.ticks = RTC_Ticks;
+        block.payload.diag = TLE9201SG.diag;
+        block.payload.control = TLE9201SG.control;
+        block.payload.duty = RAMP.duty;
+        block.payload.ramp = RAMP.state;
+#ifdef CURRENT_CONTROL
+        block.payload.current = CURRENT_Loop.measured;
+#else
+        block.payload.current = 0;
+#endif
+    }
+    block.payload.mode = TLE9201SG.mode;
+    block.payload.revision = TLE9201SG.revision;
+    block.payload.direction = TLE9201SG.mode ? TLE9201SG.SDIR : GET_BIT(PORTD.OUT, PIN5_bp);
+    block.payload.running = TLE9201SG_Running() ? 1 : 0;
+    block.payload.pwm_freq = TLE9201SG.pwm_freq;
+    block.payload.duty_cycle = TLE9201SG.duty_cycle;
+    block.payload.rpm = speed.rpm;
+
+    uint16_t crc = TELEMETRY_CRC(block.bytes, sizeof(TELEMETRY_PAYLOAD));
+    block.bytes[sizeof(TELEMETRY_PAYLOAD)] = crc & 0xFF;
+    block.bytes[sizeof(TELEMETRY_PAYLOAD) + 1] = crc >> 8;
+
+    TELEMETRY.length = TELEMETRY_Encode(block.bytes, sizeof(block.bytes), TELEMETRY.frame[TELEMETRY.back]);
+}
+
+/**
+ * @brief Sets the telemetry rate.
+ *
+ * @param rate Frames per second (up to RTC_TICK_HZ), 0 to stop the stream.
+ */
+void TELEMETRY_set_rate(uint16_t rate) {
+    if (rate > RTC_TICK_HZ) {
+        rate = RTC_TICK_HZ;
+    }
+    TELEMETRY.interval = rate ? RTC_TICK_HZ / rate : 0;
+}
+
+/**
+ * @brief Takes and sends telemetry frames on schedule (main loop).
+ *
+ * @details The snapshot is taken when the frame is due even if the previous frame
+ *          is still on the wire; it is sent as soon as the transmitter is free.
+ *          Never blocks.
+ */
+void TELEMETRY_Task() {
+    PROFILE_BEGIN(PROFILE_TELEMETRY_TASK);
+    if (!TELEMETRY.length && TELEMETRY.interval) {
+        uint32_t now;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            now = RTC_Ticks;
+        }
+        if ((int32_t)(now - TELEMETRY.due) >= 0) {
+            TELEMETRY.due += TELEMETRY.interval;
+            if ((int32_t)(now - TELEMETRY.due) >= 0) {
+                TELEMETRY.due = now + TELEMETRY.interval; // Fell behind, drop the missed frames
+            }
+            TELEMETRY_Snapshot();
+        }
+    }
+    if (TELEMETRY.length && USART1_Send(TELEMETRY.frame[TELEMETRY.back], TELEMETRY.length)) {
+        TELEMETRY.back ^= 1; // Fill the other buffer next
+        TELEMETRY.length = 0;
+    }
+    PROFILE_END(PROFILE_TELEMETRY_TASK);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file Telemetry.h
+ * @brief Header file for the binary telemetry stream on USART1.
+ *
+ * @details Every frame is a TELEMETRY_PAYLOAD followed by its CRC-16/CCITT-FALSE
+ *          (little endian), COBS encoded and terminated by a 0x00 byte. All fields are
+ *          little endian and packed. Tools/telemetry.py decodes the stream on Linux.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+/** @brief Frame type of a telemetry frame (first payload byte). */
+#define TELEMETRY_TYPE 0x01
+
+/** @brief Default telemetry rate in frames per second. */
+#define TELEMETRY_RATE_HZ 50
+
+/**
+ * @struct TELEMETRY_PAYLOAD
+ * @brief Contents of one telemetry frame.
+ */
+typedef struct {
+    uint8_t type;        ///< TELEMETRY_TYPE.
+    uint8_t sequence;    ///< Frame counter, wraps; gaps show lost frames.
+    uint32_t ticks;      ///< RTC_Ticks when the snapshot was taken.
+    uint8_t mode;        ///< TLE9201SG_MODE_SPI or TLE9201SG_MODE_PWMDIR.
+    uint8_t revision;    ///< TLE9201SG revision.
+    uint8_t diag;        ///< Raw diagnosis register.
+    uint8_t control;     ///< Raw control register.
+    uint8_t fault;       ///< Fault status (see TLE9201SG_Fault_Status()).
+    uint8_t direction;   ///< Direction (SDIR or the DIR pin).
+    uint8_t running;     ///< 1 while the outputs run.
+    uint8_t ramp;        ///< Ramp state (RAMP_IDLE ...).
+    uint16_t pwm_freq;   ///< PWM frequency in Hz.
+    uint16_t duty_cycle; ///< Configured duty, fraction of 65536.
+    uint16_t duty;       ///< Duty applied by the ramp, fraction of 65536.
+    uint16_t rpm;        ///< Motor speed in RPM.
+    uint16_t current;    ///< Last current sample in ADC counts (0 without CURRENT_CONTROL).
+} TELEMETRY_PAYLOAD;
+
+/** @brief Encoded frame size: payload and CRC, COBS overhead byte and delimiter. */
+#define TELEMETRY_FRAME_SIZE (sizeof(TELEMETRY_PAYLOAD) + 2 + 1 + 1)
+
+/**
+ * @struct TELEMETRY_DATA
+ * @brief Structure for storing the telemetry frame buffers and schedule.
+ */
+typedef struct {
+    uint8_t frame[2][TELEMETRY_FRAME_SIZE]; ///< Encoded frames, one on the wire and one being filled.
+    uint8_t length;      ///< Encoded length of the back frame, 0 if none is waiting.
+    uint8_t back;        ///< Index of the frame that is filled next.
+    uint8_t sequence;    ///< Sequence number of the next frame.
+    uint16_t interval;   ///< RTC ticks between frames, 0 to stop the stream.
+    uint32_t due;        ///< RTC_Ticks value when the next frame is due.
+} TELEMETRY_DATA;
+
+/** @brief Global variable for storing the telemetry state. */
+extern TELEMETRY_DATA TELEMETRY;
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,25 @@
+/**
+ * @file TelemetryVar.h
+ * @brief Initialization of the telemetry global variable.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef TELEMETRYVAR_H_
+#define TELEMETRYVAR_H_
+
+#include "Telemetry.h" ///< Include the header file for the TELEMETRY_DATA structure definition.
+
+/**
+ * @brief Global instance of TELEMETRY_DATA structure.
+ */
+TELEMETRY_DATA TELEMETRY = {
+    .length = 0,   ///< No frame waiting.
+    .back = 0,     ///< Fill the first frame first.
+    .sequence = 0, ///< First frame is number 0.
+    .interval = RTC_TICK_HZ / TELEMETRY_RATE_HZ, ///< Default rate.
+    .due = 0       ///< First frame right away.
+};
+
+#endif /* TELEMETRYVAR_H_ */
@@ -0,0 +1,102 @@
+/**
+ * @file USART.c
+ * @brief Interrupt-driven USART1 transmitter and receiver on PC0/PC1.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+#include "USARTVar.h"
+
+/**
+ * @brief Initializes USART1 for 8N1 asynchronous operation at USART1_BAUD.
+ *
+ * @details The baud register is calculated from the cached CLK_PER frequency, so
+ *          call it after the main clock is set up.
+ */
+void USART1_init() {
+    PORTC.DIRSET = PIN0_bm; ///< TXD output
+    PORTC.DIRCLR = PIN1_bm; ///< RXD input
+    USART1.BAUD = (uint16_t)((4UL * CLOCK_Tree.per + USART1_BAUD / 2) / USART1_BAUD); ///< 64 * f_PER / (16 * baud), rounded
+    USART1.CTRLC = USART_CHSIZE_8BIT_gc; ///< Asynchronous, 8 data bits, no parity, 1 stop bit
+    USART1.CTRLA = USART_RXCIE_bm; ///< Receive complete interrupt fills the ring buffer
+    USART1.CTRLB = USART_TXEN_bm | USART_RXEN_bm; ///< Enable the transmitter and the receiver
+}
+
+/**
+ * @brief Starts sending a buffer in the background.
+ *
+ * @details Zero-copy: the data register empty interrupt reads `data` directly.
+ *
+ * @param data Bytes to send, must stay valid until USART1_Busy() returns 0.
+ * @param length Number of bytes (1 to 255).
+ * @return 1 if started, 0 if a transmission is still in progress.
+ */
+uint8_t USART1_Send(const uint8_t *data, uint8_t length) {
+    if (USART1_Tx.length || !length) {
+        return 0;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        USART1_Tx.data = data;
+        USART1_Tx.length = length;
+        USART1.CTRLA |= USART_DREIE_bm; ///< The interrupt takes it from here
+    }
+    return 1;
+}
+
+/**
+ * @brief Tells whether a transmission is in progress.
+ *
+ * @return Bytes still to be handed to the transmitter, 0 when idle.
+ */
+uint8_t USART1_Busy() {
+    return USART1_Tx.length;
+}
+
+/**
+ * @brief USART1 data register empty interrupt: sends the next byte.
+ */
+ISR(USART1_DRE_vect) {
+    USART1.TXDATAL = *USART1_Tx.data++;
+    if (!--USART1_Tx.length) {
+        USART1.CTRLA &= ~USART_DREIE_bm; ///< Buffer done
+    }
+}
+
+/**
+ * @brief Takes the next received byte out of the ring buffer.
+ *
+ * @param byte Receives the byte.
+ * @return 1 if a byte was read, 0 if the buffer is empty.
+ */
+uint8_t USART1_Read(uint8_t *byte) {
+    uint8_t tail = USART1_Rx.tail;
+    if (tail == USART1_Rx.head) {
+        return 0;
+    }
+    *byte = USART1_Rx.buffer[tail];
+    USART1_Rx.tail = (tail + 1) & (USART1_RX_SIZE - 1); // Single byte store, no lock needed
+    return 1;
+}
+
+/**
+ * @brief USART1 receive complete interrupt: stores the byte in the ring buffer.
+ *
+ * @details A byte that does not fit, or one received after a hardware overrun, is
+ *          reported through `overflow` so the parser can drop the broken frame.
+ */
+ISR(USART1_RXC_vect) {
+    if (USART1.RXDATAH & USART_BUFOVF_bm) {
+        USART1_Rx.overflow = 1;
+    }
+    uint8_t data = USART1.RXDATAL;
+    uint8_t head = USART1_Rx.head;
+    uint8_t next = (head + 1) & (USART1_RX_SIZE - 1);
+    if (next == USART1_Rx.tail) {
+        USART1_Rx.overflow = 1; // Buffer full, byte lost
+        return;
+    }
+    USART1_Rx.buffer[head] = data;
+    USART1_Rx.head = next;
+}
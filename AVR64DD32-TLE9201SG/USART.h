@@ -0,0 +1,50 @@
+/**
+ * @file USART.h
+ * @brief Header file for the interrupt-driven USART1 link (PC0 TXD, PC1 RXD).
+ *
+ * @details A transmission hands a pointer to an encoded frame to the data register
+ *          empty interrupt, which sends it byte by byte straight from the caller's
+ *          buffer. The buffer must stay untouched until USART1_Busy() returns 0.
+ *          Received bytes are stored in a ring buffer by the receive complete
+ *          interrupt and taken out with USART1_Read().
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef USART_H_
+#define USART_H_
+
+/** @brief USART1 baud rate. */
+#define USART1_BAUD 115200UL
+
+/** @brief Size of the USART1 receive ring buffer (power of two, one slot stays free). */
+#define USART1_RX_SIZE 32
+
+/**
+ * @struct USART1_TX_DATA
+ * @brief State of the USART1 transmission in progress.
+ */
+typedef struct {
+    const uint8_t *data; ///< Next byte to send.
+    uint8_t length;      ///< Bytes left, 0 when idle.
+} USART1_TX_DATA;
+
+/**
+ * @struct USART1_RX_DATA
+ * @brief Ring buffer of received USART1 bytes.
+ */
+typedef struct {
+    uint8_t buffer[USART1_RX_SIZE]; ///< Received bytes.
+    uint8_t head;     ///< Index the interrupt writes next.
+    uint8_t tail;     ///< Index USART1_Read() takes next.
+    uint8_t overflow; ///< Set when bytes were lost (buffer full or hardware overrun).
+} USART1_RX_DATA;
+
+/** @brief Global USART1 transmission state. */
+extern volatile USART1_TX_DATA USART1_Tx;
+
+/** @brief Global USART1 receive buffer. */
+extern volatile USART1_RX_DATA USART1_Rx;
+
+#endif /* USART_H_ */
@@ -0,0 +1,31 @@
+/**
+ * @file USARTVar.h
+ * @brief Initialization of the USART1 transmission and receive state global variables.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef USARTVAR_H_
+#define USARTVAR_H_
+
+#include "USART.h" ///< Include the header file for the USART1_TX_DATA and USART1_RX_DATA structure definitions.
+
+/**
+ * @brief Global instance of USART1_TX_DATA structure.
+ */
+volatile USART1_TX_DATA USART1_Tx = {
+    .data = 0,  ///< Nothing to send.
+    .length = 0 ///< Transmitter idle.
+};
+
+/**
+ * @brief Global instance of USART1_RX_DATA structure.
+ */
+volatile USART1_RX_DATA USART1_Rx = {
+    .head = 0,    ///< Buffer is empty.
+    .tail = 0,    ///< Buffer is empty.
+    .overflow = 0 ///< Nothing lost yet.
+};
+
+#endif /* USARTVAR_H_ */
@@ -11,9 +11,13 @@
  * @brief The main function initializes peripherals and controls the TLE9201SG driver based on input pins.
  * 
  * This function performs the following steps:
- * - Initializes GPIO and the internal high-frequency clock.
- * - Configures the TLE9201SG PWM frequency and duty cycle.
- * - Monitors input pins (PF5 and PF6) to start, stop, or change the direction of the TLE9201SG.
+ * - Initializes GPIO, the internal high-frequency clock, the RTC tick used for debouncing
+ *   and the TCA0 control tick that ramps the duty cycle on start and stop.
+ * - Starts the encoder speed measurement and the USART1 link (telemetry and commands).
+ * - Configures the TLE9201SG PWM frequency and duty cycle and starts the diagnosis history.
+ * - Waits for debounced input events (PF5 and PF6) to start, stop, or change the direction
+ *   of the TLE9201SG, executing USART1 commands, sending telemetry frames when due and
+ *   sleeping in between.
  * 
  * @return int Always returns 0 (not used in embedded systems).
  */
@@ -21,22 +25,48 @@ int main(void)
 {
     GPIO_init();
     CLOCK_INHF_clock_init(); ///< Initializes the internal high-frequency clock.
+#ifdef PROFILE
+    PROFILE_init(); ///< Cycle counter for the profiled regions.
+#endif
+    RTC_init(); ///< Starts the system tick used for input debouncing.
+    TCA0_Tick_init(); ///< Starts the control tick that ramps the duty cycle.
+    SPEED_init(); ///< Measures the motor speed from the encoder on PC2 (needs the TCA0 clock).
+    USART1_init(); ///< Telemetry and command link on PC0/PC1 (needs the CLK_PER frequency).
+    set_sleep_mode(SLEEP_MODE_IDLE); ///< Peripherals keep running while the CPU sleeps.
+    sei(); ///< Enables global interrupts (SPI0 frames are interrupt driven).
+
+#ifdef BENCHMARK
+    BENCHMARK_run(); ///< Benchmark image: measures the driver and reports over USART1.
+#endif
 
     TLE9201SG.pwm_freq = 20000; ///< Sets PWM frequency to 20 kHz. Always set this before mode initialization.
-    TLE9201SG.duty_cycle = 30.0; ///< Sets duty cycle to 50%. Always set this before mode initialization.
+    TLE9201SG.duty_cycle = PWM_DUTY_PERCENT(30); ///< Sets duty cycle to 30%. Always set this before mode initialization.
 
+    DIAG_init(); ///< Records diagnosis changes and counts faults.
+#ifdef JITTER
+    JITTER_init(); ///< Period histograms for the configured PWM frequency.
+#endif
     TLE9201SG_Mode_init(TLE9201SG_MODE_PWMDIR); ///< Initializes the TLE9201SG in SPI mode.
+#ifdef SPEED_CONTROL
+    PID_ON(); ///< Speed controller sets the duty, duty_cycle is the highest it may use.
+#endif
 
+    uint8_t inputs;
     while (1) {
-        if (!(PORTF.IN & PIN5_bm)) { ///< Starts TLE9201SG if PF5 is low.
-            TLE9201SG_START();
-            if (!(PORTF.IN & PIN6_bm)) { ///< Changes direction based on PF6.
-                TLE9201SG_DIR(1); ///< Sets direction to forward.
-            } else {
-                TLE9201SG_DIR(0); ///< Sets direction to reverse.
+        while (GPIO_Event_Get(&inputs)) { ///< Only act on input changes.
+            if (!(inputs & PIN5_bm)) { ///< Starts TLE9201SG if PF5 is low.
+                if (!(inputs & PIN6_bm)) { ///< Changes direction based on PF6.
+                    TLE9201SG_DIR(1); ///< Sets direction to forward (reverses along the ramp while running).
+                } else {
+                    TLE9201SG_DIR(0); ///< Sets direction to reverse (reverses along the ramp while running).
+                }
+                TLE9201SG_START();
+            } else { ///< Stops TLE9201SG if PF5 is high.
+                TLE9201SG_STOP();
             }
-        } else { ///< Stops TLE9201SG if PF5 is high.
-            TLE9201SG_STOP();
         }
+        COMMAND_Task(); ///< Parses received commands, bounded work per pass.
+        TELEMETRY_Task(); ///< Snapshots and sends the driver state when a frame is due.
+        GPIO_Event_Wait(); ///< Sleeps until the next interrupt.
     }
 }
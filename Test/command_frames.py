@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Writes the requests used by test_command.c, encoded by Tools/command.py.
+
+    command_frames.py build/command_frames.h
+
+Every request gets its own sequence number (SEQ_<name>) and is stored with its
+delimiters (FRAME_<name>), exactly as command.py puts it on the line.
+"""
+
+import os
+import struct
+import sys
+
+sys.dont_write_bytecode = True  # Keep Tools/ clean
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Tools"))
+import command  # noqa: E402
+
+REQUESTS = (
+    ("SET_DUTY", command.SET_DUTY, struct.pack("<H", 0x8000)),
+    ("SET_DUTY_SHORT", command.SET_DUTY, b"\x80"),
+    ("SET_FREQ", command.SET_FREQ, struct.pack("<H", 10000)),
+    ("SET_FREQ_ZERO", command.SET_FREQ, struct.pack("<H", 0)),
+    ("START", command.START, b""),
+    ("STOP", command.STOP, b""),
+    ("DIR", command.DIR, b"\x01"),
+    ("DIR_INVALID", command.DIR, b"\x02"),
+    ("MODE_SPI", command.MODE, b"\x01"),
+    ("MODE_PWM", command.MODE, b"\x00"),
+    ("READ", command.READ, b""),
+    ("TELEMETRY", command.TELEMETRY, struct.pack("<H", 0)),
+    ("HISTORY", command.HISTORY, b"\x00"),
+    ("FAULTS", command.FAULTS, b""),
+    ("PROFILE", command.PROFILE, b"\x00"),
+    ("JITTER", command.JITTER, b"\x00"),
+    ("UNKNOWN", 0x42, b""),
+)
+
+
+def main(path):
+    lines = ["/* Generated by command_frames.py from Tools/command.py, do not edit. */", ""]
+    for sequence, (name, code, args) in enumerate(REQUESTS, 1):
+        frame = command.request(code, sequence, args)
+        lines.append("#define SEQ_%s %d" % (name, sequence))
+        lines.append("static const uint8_t FRAME_%s[] = { %s };" % (name, ", ".join("0x%02X" % b for b in frame)))
+    with open(path, "w") as out:
+        out.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1])
@@ -0,0 +1,19 @@
+/**
+ * @file cpufunc.h
+ * @brief Host stand-in for <avr/cpufunc.h> used by the unit tests.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef MOCK_AVR_CPUFUNC_H_
+#define MOCK_AVR_CPUFUNC_H_
+
+#include <stdint.h>
+
+/** @brief Writes a protected register; there is no configuration change protection to unlock. */
+static inline void ccp_write_io(void *address, uint8_t value) {
+    *(volatile uint8_t *)address = value;
+}
+
+#endif /* MOCK_AVR_CPUFUNC_H_ */
@@ -0,0 +1,22 @@
+/**
+ * @file interrupt.h
+ * @brief Host stand-in for <avr/interrupt.h> used by the unit tests.
+ *
+ * @details An interrupt handler becomes a plain function named after its vector, so a
+ *          test raises an interrupt by calling it (e.g. TCB0_INT_vect()). There is only
+ *          one thread, so sei() and cli() do nothing.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef MOCK_AVR_INTERRUPT_H_
+#define MOCK_AVR_INTERRUPT_H_
+
+/** @brief Defines an interrupt handler as an ordinary function. */
+#define ISR(vector) void vector(void); void vector(void)
+
+#define sei()
+#define cli()
+
+#endif /* MOCK_AVR_INTERRUPT_H_ */
@@ -0,0 +1,295 @@
+/**
+ * @file io.h
+ * @brief Host stand-in for <avr/io.h> used by the unit tests.
+ *
+ * @details The peripherals the driver touches are plain structs in RAM (instances in
+ *          mock_io.c), laid out with the register names of the AVR64DD32 but not its
+ *          addresses. Tests preset status bits (MOCK_Reset()) and read back what the
+ *          driver wrote. Only the bit masks and group configurations used by the
+ *          driver are defined; their values match the device header.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef MOCK_AVR_IO_H_
+#define MOCK_AVR_IO_H_
+
+#include <stdint.h>
+
+typedef volatile uint8_t register8_t;   ///< 8-bit I/O register.
+typedef volatile uint16_t register16_t; ///< 16-bit I/O register.
+
+typedef struct {
+    register8_t DIR, DIRSET, DIRCLR, DIRTGL, OUT, OUTSET, OUTCLR, OUTTGL, IN, INTFLAGS, PORTCTRL,
+                PINCONFIG, PINCTRLUPD, PINCTRLSET, PINCTRLCLR, PIN0CTRL, PIN1CTRL, PIN2CTRL,
+                PIN3CTRL, PIN4CTRL, PIN5CTRL, PIN6CTRL, PIN7CTRL;
+} PORT_t;
+extern PORT_t PORTA, PORTC, PORTD, PORTF;
+
+typedef struct {
+    register8_t CTRLA, CTRLB, INTCTRL, INTFLAGS, DATA;
+} SPI_t;
+extern SPI_t SPI0;
+
+typedef struct {
+    register8_t CTRLA, CTRLB, CTRLC, CTRLD, CTRLE, EVCTRLA, EVCTRLB, INTCTRL, INTFLAGS, STATUS,
+                INPUTCTRLA, INPUTCTRLB, FAULTCTRL, DLYCTRL, DLYVAL, DITCTRL, DITVAL, DBGCTRL;
+    register16_t CAPTUREA, CAPTUREB, CMPASET, CMPACLR, CMPBSET, CMPBCLR;
+} TCD_t;
+extern TCD_t TCD0;
+
+typedef struct {
+    register8_t CTRLA, CTRLB, EVCTRL, INTCTRL, INTFLAGS, STATUS, DBGCTRL, TEMP;
+    register16_t CNT, CCMP;
+} TCB_t;
+extern TCB_t TCB0, TCB1, TCB2;
+
+typedef struct {
+    register8_t CTRLA, CTRLB, CTRLC, CTRLD, CTRLECLR, CTRLESET, CTRLFCLR, CTRLFSET, EVCTRL, INTCTRL,
+                INTFLAGS, DBGCTRL, TEMP;
+    register16_t CNT, PER, CMP0, CMP1, CMP2;
+} TCA_SINGLE_t;
+
+typedef union {
+    TCA_SINGLE_t SINGLE;
+} TCA_t;
+extern TCA_t TCA0;
+
+typedef struct {
+    register8_t MCLKCTRLA, MCLKCTRLB, MCLKCTRLC, MCLKINTCTRL, MCLKINTFLAGS, MCLKSTATUS, MCLKTIMEBASE,
+                OSCHFCTRLA, OSCHFTUNE, PLLCTRLA, OSC32KCTRLA, XOSC32KCTRLA, XOSCHFCTRLA;
+} CLKCTRL_t;
+extern CLKCTRL_t CLKCTRL;
+
+typedef struct {
+    register8_t TCDROUTEA, USARTROUTEA, SPIROUTEA, TCAROUTEA;
+} PORTMUX_t;
+extern PORTMUX_t PORTMUX;
+
+typedef struct {
+    register8_t CTRLA, STATUS, INTCTRL, INTFLAGS, DBGCTRL, TEMP, CLKSEL, PITCTRLA, PITSTATUS,
+                PITINTCTRL, PITINTFLAGS, PITDBGCTRL;
+    register16_t CNT, PER, CMP;
+} RTC_t;
+extern RTC_t RTC;
+
+typedef struct {
+    register8_t SWEVENTA, CHANNEL0, CHANNEL1, CHANNEL2, CHANNEL3, CHANNEL4, CHANNEL5, USERTCD0INPUTA,
+                USERTCD0INPUTB, USERADC0START, USERTCB0CAPT, USERTCB1CAPT, USERTCB2CAPT,
+                USERTCB2COUNT;
+} EVSYS_t;
+extern EVSYS_t EVSYS;
+
+typedef struct {
+    register8_t CTRLA, CTRLB, CTRLC, CTRLD, CTRLE, SAMPCTRL, MUXPOS, MUXNEG, COMMAND, EVCTRL,
+                INTCTRL, INTFLAGS, DBGCTRL, TEMP;
+    register16_t RES, WINLT, WINHT;
+} ADC_t;
+extern ADC_t ADC0;
+
+typedef struct {
+    register8_t ADC0REF, DAC0REF, ACREF;
+} VREF_t;
+extern VREF_t VREF;
+
+typedef struct {
+    register8_t RXDATAL, RXDATAH, TXDATAL, TXDATAH, STATUS, CTRLA, CTRLB, CTRLC;
+    register16_t BAUD;
+    register8_t CTRLD, DBGCTRL, EVCTRL, TXPLCTRL, RXPLCTRL;
+} USART_t;
+extern USART_t USART0, USART1;
+
+typedef struct {
+    register8_t CTRLA;
+} SLPCTRL_t;
+extern SLPCTRL_t SLPCTRL;
+
+#define PIN0_bm 1
+#define PIN1_bm 2
+#define PIN2_bm 4
+#define PIN3_bm 8
+#define PIN4_bm 16
+#define PIN5_bm 32
+#define PIN6_bm 64
+#define PIN7_bm 128
+#define PIN0_bp 0
+#define PIN1_bp 1
+#define PIN5_bp 5
+#define PIN6_bp 6
+#define PORT_PULLUPEN_bm 8
+#define PORT_ISC_gm 7
+#define PORT_ISC_BOTHEDGES_gc 1
+#define PORT_ISC_RISING_gc 2
+#define PORT_ISC_FALLING_gc 3
+#define PORT_ISC_INTDISABLE_gc 0
+#define PORT_ISC_INPUT_DISABLE_gc 4
+#define SPI_MASTER_bm 0x20
+#define SPI_PRESC_DIV4_gc 0
+#define SPI_ENABLE_bm 1
+#define SPI_MODE_1_gc 1
+#define SPI_IF_bm 0x80
+#define SPI_IE_bm 1
+#define TCD_ENRDY_bm 1
+#define TCD_CMDRDY_bm 2
+#define TCD_ENABLE_bm 1
+#define TCD_CNTPRES_gm 0x18
+#define TCD_CNTPRES_DIV1_gc 0
+#define TCD_CNTPRES_DIV4_gc 0x08
+#define TCD_CNTPRES_DIV32_gc 0x10
+#define TCD_SYNCPRES_gm 0x06
+#define TCD_SYNCPRES_DIV1_gc 0
+#define TCD_SYNCPRES_DIV2_gc 2
+#define TCD_SYNCPRES_DIV4_gc 4
+#define TCD_SYNCPRES_DIV8_gc 6
+#define TCD_CLKSEL_gm 0x60
+#define TCD_CLKSEL_OSCHF_gc 0
+#define TCD_CLKSEL_PLL_gc 0x20
+#define TCD_CLKSEL_EXTCLK_gc 0x40
+#define TCD_CLKSEL_CLKPER_gc 0x60
+#define TCD_WGMODE_gm 3
+#define TCD_WGMODE_ONERAMP_gc 0
+#define TCD_WGMODE_TWORAMP_gc 1
+#define TCD_WGMODE_FOURRAMP_gc 2
+#define TCD_WGMODE_DS_gc 3
+#define TCD_CMPCEN_bm 0x40
+#define TCD_CMPC_bm 0x04
+#define TCD_SYNCEOC_bm 0x80
+#define TCD_SYNC_bm 0x02
+#define TCD_RESTART_bm 0x01
+#define TCD_CFG_gm 0xC0
+#define TCD_CFG_NEITHER_gc 0
+#define TCD_CFG_FILTER_gc 0x40
+#define TCD_CFG_ASYNC_gc 0x80
+#define TCD_EDGE_bm 0x10
+#define TCD_ACTION_bm 0x04
+#define TCD_ACTION_FAULT_gc 0
+#define TCD_ACTION_CAPTURE_gc 4
+#define TCD_TRIGEI_bm 1
+#define TCD_INPUTMODE_gm 0x0F
+#define TCD_INPUTMODE_NONE_gc 0
+#define TCD_INPUTMODE_WAITSW_gc 7
+#define TCD_OVF_bm 1
+#define TCD_TRIGA_bm 4
+#define TCD_TRIGB_bm 8
+#define TCD_DITHERSEL_ONTIMEB_gc 0
+#define TCB_ENABLE_bm 1
+#define TCB_CLKSEL_gm 0x0E
+#define TCB_CLKSEL_DIV1_gc 0
+#define TCB_CLKSEL_DIV2_gc 2
+#define TCB_CLKSEL_TCA0_gc 4
+#define TCB_RUNSTDBY_bm 0x40
+#define TCB_CNTMODE_INT_gc 0
+#define TCB_CNTMODE_FRQ_gc 3
+#define TCB_CNTMODE_PW_gc 4
+#define TCB_CNTMODE_FRQPW_gc 5
+#define TCB_CAPTEI_bm 1
+#define TCB_EDGE_bm 0x10
+#define TCB_FILTER_bm 0x40
+#define TCB_CAPT_bm 1
+#define TCB_OVF_bm 2
+#define TCA_SINGLE_CLKSEL_DIV1_gc 0
+#define TCA_SINGLE_CLKSEL_DIV2_gc 2
+#define TCA_SINGLE_CLKSEL_DIV4_gc 4
+#define TCA_SINGLE_CLKSEL_DIV8_gc 6
+#define TCA_SINGLE_CLKSEL_DIV16_gc 8
+#define TCA_SINGLE_CLKSEL_DIV64_gc 10
+#define TCA_SINGLE_ENABLE_bm 1
+#define TCA_SINGLE_OVF_bm 1
+#define TCA_SINGLE_WGMODE_NORMAL_gc 0
+#define CLKCTRL_RUNSTDBY_bm 0x80
+#define CLKCTRL_CSUTHF_1K_gc 0
+#define CLKCTRL_FRQRANGE_32M_gc 0x0C
+#define CLKCTRL_SELHF_XTAL_gc 0
+#define CLKCTRL_SELHF_EXTCLOCK_gc 2
+#define CLKCTRL_ENABLE_bm 1
+#define CLKCTRL_EXTS_bm 0x80
+#define CLKCTRL_SOSC_bm 1
+#define CLKCTRL_PLLS_bm 0x20
+#define CLKCTRL_CLKSEL_gm 0x0F
+#define CLKCTRL_CLKSEL_OSCHF_gc 0
+#define CLKCTRL_CLKSEL_OSC32K_gc 1
+#define CLKCTRL_CLKSEL_XOSC32K_gc 2
+#define CLKCTRL_CLKSEL_EXTCLK_gc 3
+#define CLKCTRL_PDIV_gm 0x1E
+#define CLKCTRL_PEN_bm 1
+#define CLKCTRL_PDIV_2X_gc 0
+#define CLKCTRL_PDIV_4X_gc 2
+#define CLKCTRL_PDIV_8X_gc 4
+#define CLKCTRL_PDIV_16X_gc 6
+#define CLKCTRL_PDIV_32X_gc 8
+#define CLKCTRL_PDIV_64X_gc 10
+#define CLKCTRL_PDIV_6X_gc 16
+#define CLKCTRL_PDIV_10X_gc 18
+#define CLKCTRL_PDIV_12X_gc 20
+#define CLKCTRL_PDIV_24X_gc 22
+#define CLKCTRL_PDIV_48X_gc 24
+#define CLKCTRL_FRQSEL_gm 0x3C
+#define CLKCTRL_FRQSEL_1M_gc 0
+#define CLKCTRL_FRQSEL_2M_gc 4
+#define CLKCTRL_FRQSEL_3M_gc 8
+#define CLKCTRL_FRQSEL_4M_gc 12
+#define CLKCTRL_FRQSEL_8M_gc 20
+#define CLKCTRL_FRQSEL_12M_gc 24
+#define CLKCTRL_FRQSEL_16M_gc 28
+#define CLKCTRL_FRQSEL_20M_gc 32
+#define CLKCTRL_FRQSEL_24M_gc 36
+#define CLKCTRL_MULFAC_gm 3
+#define CLKCTRL_MULFAC_OFF_gc 0
+#define CLKCTRL_MULFAC_2x_gc 1
+#define CLKCTRL_MULFAC_3x_gc 2
+#define CLKCTRL_SOURCE_bm 0x40
+#define PORTMUX_TCD0_ALT4_gc 4
+#define PORTMUX_USART1_gm 0x0C
+#define PORTMUX_USART1_DEFAULT_gc 0
+#define RTC_CLKSEL_OSC32K_gc 0
+#define RTC_PERIOD_CYC32_gc 0x20
+#define RTC_PITEN_bm 1
+#define RTC_PI_bm 1
+#define RTC_CTRLBUSY_bm 1
+#define EVSYS_CHANNEL0_PORTA_PIN5_gc 0x45
+#define EVSYS_CHANNEL1_TCD0_CMPBCLR_gc 0xB0
+#define EVSYS_CHANNEL2_PORTD_PIN7_gc 0x47
+#define EVSYS_CHANNEL2_PORTC_PIN2_gc 0x42
+#define EVSYS_CHANNEL4_PORTF_PIN2_gc 0x42
+#define EVSYS_USER_CHANNEL0_gc 1
+#define EVSYS_USER_CHANNEL1_gc 2
+#define EVSYS_USER_CHANNEL2_gc 3
+#define EVSYS_USER_CHANNEL4_gc 5
+#define ADC_ENABLE_bm 1
+#define ADC_RESSEL_12BIT_gc 0
+#define ADC_PRESC_DIV4_gc 1
+#define ADC_PRESC_DIV8_gc 3
+#define ADC_MUXPOS_AIN22_gc 0x16
+#define ADC_MUXPOS_AIN23_gc 0x17
+#define ADC_MUXPOS_AIN1_gc 0x01
+#define ADC_MUXPOS_AIN2_gc 0x02
+#define ADC_STARTEI_bm 1
+#define ADC_RESRDY_bm 1
+#define ADC_SAMPNUM_NONE_gc 0
+#define ADC_INITDLY_DLY16_gc 0x20
+#define VREF_REFSEL_VDD_gc 5
+#define VREF_REFSEL_2V048_gc 1
+#define USART_RXCIE_bm 0x80
+#define USART_TXCIE_bm 0x40
+#define USART_DREIE_bm 0x20
+#define USART_TXEN_bm 0x40
+#define USART_RXEN_bm 0x80
+#define USART_CHSIZE_8BIT_gc 3
+#define USART_DREIF_bm 0x20
+#define USART_RXCIF_bm 0x80
+#define USART_BUFOVF_bm 0x40
+#define USART_FERR_bm 0x04
+#define SLPCTRL_SMODE_IDLE_gc 0
+#define SLPCTRL_SEN_bm 1
+#define EVSYS_CHANNEL1_TCD0_PROGEV_gc 0xB3
+#define ADC_PRESC_DIV16_gc 7
+#define TCD_DLYSEL_EVENT_gc 2
+#define TCD_DLYTRIG_CMPBCLR_gc 0x0C
+#define TCD_DLYPRESC_gp 4
+#define ADC_MUXPOS_AIN3_gc 0x03
+
+/** @brief Clears every mock register and sets the ready flags the driver waits for. */
+void MOCK_Reset(void);
+
+#endif /* MOCK_AVR_IO_H_ */
@@ -0,0 +1,20 @@
+/**
+ * @file sleep.h
+ * @brief Host stand-in for <avr/sleep.h> used by the unit tests, the CPU never sleeps.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef MOCK_AVR_SLEEP_H_
+#define MOCK_AVR_SLEEP_H_
+
+#define SLEEP_MODE_IDLE 0
+
+#define set_sleep_mode(mode)
+#define sleep_enable()
+#define sleep_disable()
+#define sleep_cpu()
+#define sleep_mode()
+
+#endif /* MOCK_AVR_SLEEP_H_ */
@@ -0,0 +1,56 @@
+/**
+ * @file mock_io.c
+ * @brief Register instances of the host <avr/io.h> used by the unit tests.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include <string.h>
+#include <avr/io.h>
+
+PORT_t PORTA, PORTC, PORTD, PORTF;
+SPI_t SPI0;
+TCD_t TCD0;
+TCB_t TCB0, TCB1, TCB2;
+TCA_t TCA0;
+CLKCTRL_t CLKCTRL;
+PORTMUX_t PORTMUX;
+RTC_t RTC;
+EVSYS_t EVSYS;
+ADC_t ADC0;
+VREF_t VREF;
+USART_t USART0, USART1;
+SLPCTRL_t SLPCTRL;
+
+/**
+ * @brief Clears every mock register and sets the ready flags the driver waits for.
+ *
+ * @details TCD0 is always ready for enable changes and commands and the clock
+ *          switches are done at once. The PORTF buttons read released (pulled up) and
+ *          the fault flag on PA5 reads low. Nothing else changes by itself.
+ */
+void MOCK_Reset(void) {
+    memset((void *)&PORTA, 0, sizeof(PORTA));
+    memset((void *)&PORTC, 0, sizeof(PORTC));
+    memset((void *)&PORTD, 0, sizeof(PORTD));
+    memset((void *)&PORTF, 0, sizeof(PORTF));
+    memset((void *)&SPI0, 0, sizeof(SPI0));
+    memset((void *)&TCD0, 0, sizeof(TCD0));
+    memset((void *)&TCB0, 0, sizeof(TCB0));
+    memset((void *)&TCB1, 0, sizeof(TCB1));
+    memset((void *)&TCB2, 0, sizeof(TCB2));
+    memset((void *)&TCA0, 0, sizeof(TCA0));
+    memset((void *)&CLKCTRL, 0, sizeof(CLKCTRL));
+    memset((void *)&PORTMUX, 0, sizeof(PORTMUX));
+    memset((void *)&RTC, 0, sizeof(RTC));
+    memset((void *)&EVSYS, 0, sizeof(EVSYS));
+    memset((void *)&ADC0, 0, sizeof(ADC0));
+    memset((void *)&VREF, 0, sizeof(VREF));
+    memset((void *)&USART0, 0, sizeof(USART0));
+    memset((void *)&USART1, 0, sizeof(USART1));
+    memset((void *)&SLPCTRL, 0, sizeof(SLPCTRL));
+
+    TCD0.STATUS = TCD_ENRDY_bm | TCD_CMDRDY_bm;
+    PORTF.IN = 0xFF;
+}
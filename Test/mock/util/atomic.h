@@ -0,0 +1,20 @@
+/**
+ * @file atomic.h
+ * @brief Host stand-in for <util/atomic.h> used by the unit tests.
+ *
+ * @details Runs the block once, like the avr-libc macro, without touching any
+ *          interrupt flag: interrupt handlers only run when a test calls them.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef MOCK_UTIL_ATOMIC_H_
+#define MOCK_UTIL_ATOMIC_H_
+
+#define ATOMIC_BLOCK(type) for (uint8_t atomic_once = 1; atomic_once; atomic_once = 0)
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+
+#endif /* MOCK_UTIL_ATOMIC_H_ */
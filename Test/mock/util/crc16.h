@@ -0,0 +1,23 @@
+/**
+ * @file crc16.h
+ * @brief Host stand-in for <util/crc16.h> used by the unit tests.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef MOCK_UTIL_CRC16_H_
+#define MOCK_UTIL_CRC16_H_
+
+#include <stdint.h>
+
+/** @brief CRC-16/XMODEM step (polynomial 0x1021), same result as the avr-libc version. */
+static inline uint16_t _crc_xmodem_update(uint16_t crc, uint8_t data) {
+    crc ^= (uint16_t)data << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+#endif /* MOCK_UTIL_CRC16_H_ */
@@ -0,0 +1,18 @@
+/**
+ * @file delay.h
+ * @brief Host stand-in for <util/delay.h> used by the unit tests, delays return at once.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef MOCK_UTIL_DELAY_H_
+#define MOCK_UTIL_DELAY_H_
+
+#include <stdint.h>
+
+static inline void _delay_loop_2(uint16_t count) { (void)count; }
+static inline void _delay_ms(double ms) { (void)ms; }
+static inline void _delay_us(double us) { (void)us; }
+
+#endif /* MOCK_UTIL_DELAY_H_ */
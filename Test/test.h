@@ -0,0 +1,62 @@
+/**
+ * @file test.h
+ * @brief Minimal assertion helpers for the host unit tests.
+ *
+ * @details Every test program is one translation unit that includes this header, runs
+ *          its cases with TEST_RUN() and returns TEST_Result() from main(): a failed
+ *          check prints where it failed and makes the program exit non-zero.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+
+static unsigned TEST_Failures; ///< Failed checks so far.
+static unsigned TEST_Checks;   ///< Checks so far.
+
+/** @brief Fails the running test if `condition` is false. */
+#define CHECK(condition) do { \
+    TEST_Checks++; \
+    if (!(condition)) { \
+        TEST_Failures++; \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+    } \
+} while (0)
+
+/** @brief Fails the running test if `actual` differs from `expected` (compared as unsigned long). */
+#define CHECK_EQUAL(expected, actual) do { \
+    unsigned long check_expected = (unsigned long)(expected); \
+    unsigned long check_actual = (unsigned long)(actual); \
+    TEST_Checks++; \
+    if (check_expected != check_actual) { \
+        TEST_Failures++; \
+        printf("%s:%d: %s is %lu (0x%lX), expected %lu (0x%lX)\n", __FILE__, __LINE__, \
+               #actual, check_actual, check_actual, check_expected, check_expected); \
+    } \
+} while (0)
+
+/** @brief Runs one test case and names it if it failed. */
+#define TEST_RUN(test) do { \
+    unsigned test_before = TEST_Failures; \
+    test(); \
+    if (TEST_Failures != test_before) { \
+        printf("FAIL %s\n", #test); \
+    } \
+} while (0)
+
+/**
+ * @brief Prints the summary line of a test program.
+ *
+ * @param name Name of the test program.
+ * @return Exit code for main(): 0 if every check passed.
+ */
+static inline int TEST_Result(const char *name) {
+    printf("%s: %u checks, %u failed\n", name, TEST_Checks, TEST_Failures);
+    return TEST_Failures ? 1 : 0;
+}
+
+#endif /* TEST_H_ */
@@ -0,0 +1,281 @@
+/**
+ * @file test_command.c
+ * @brief Host loopback tests of the USART1 command parser.
+ *
+ * @details The requests are encoded by Tools/command.py (command_frames.h, generated
+ *          by command_frames.py) and fed byte by byte through the USART1 receive
+ *          interrupt. COMMAND_Task() parses them, and the replies are collected from
+ *          the data register empty interrupt, decoded and CRC checked. The driver
+ *          runs in PWM/DIR mode on the mock registers.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include <string.h>
+#include "Settings.h"
+#include "test.h"
+#include "command_frames.h"
+
+void USART1_RXC_vect(void); ///< Receive complete (USART.c)
+void USART1_DRE_vect(void); ///< Data register empty (USART.c)
+
+static uint8_t tx[256];    ///< Bytes sent by USART1.
+static uint8_t tx_length;  ///< Bytes in `tx`.
+static uint8_t reply[64];  ///< Last decoded reply without the CRC.
+static uint8_t reply_length; ///< Bytes in `reply`, 0 if none arrived.
+
+/**
+ * @brief Receives bytes on USART1, one interrupt per byte.
+ */
+static void receive(const uint8_t *data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        USART1.RXDATAH = 0;
+        USART1.RXDATAL = data[i];
+        USART1_RXC_vect();
+    }
+}
+
+/**
+ * @brief Runs the command task like the main loop and sends what it queued.
+ */
+static void run() {
+    for (uint8_t pass = 0; pass < 8; pass++) {
+        COMMAND_Task();
+        while (USART1.CTRLA & USART_DREIE_bm) {
+            USART1_DRE_vect();
+            tx[tx_length++] = USART1.TXDATAL;
+        }
+    }
+}
+
+/**
+ * @brief Decodes the next reply frame from the sent bytes.
+ *
+ * @return 1 if a frame with a good CRC was found, 0 otherwise.
+ */
+static uint8_t take_reply() {
+    uint8_t *end = memchr(tx, 0, tx_length);
+    reply_length = 0;
+    if (!end) {
+        return 0;
+    }
+    uint8_t length = end - tx;
+    uint8_t frame[64];
+    memcpy(frame, tx, length);
+    tx_length -= length + 1;
+    memmove(tx, end + 1, tx_length);
+
+    length = COMMAND_Decode(frame, length);
+    if (length < 5 || TELEMETRY_CRC(frame, length - 2) != (frame[length - 2] | (frame[length - 1] << 8))) {
+        return 0;
+    }
+    reply_length = length - 2;
+    memcpy(reply, frame, reply_length);
+    return 1;
+}
+
+/**
+ * @brief Sends one request and checks the reply header.
+ *
+ * @return Reply status, 0xFF if no reply arrived.
+ */
+static uint8_t transact(const uint8_t *frame, uint8_t length) {
+    receive(frame, length);
+    run();
+    if (!take_reply()) {
+        return 0xFF;
+    }
+    CHECK_EQUAL(frame[2] | COMMAND_REPLY, reply[0]); // Delimiter, COBS code, then the command
+    return reply[2];
+}
+
+/** @brief Sends a request from command_frames.h and returns the reply status. */
+#define TRANSACT(name) transact(FRAME_##name, sizeof(FRAME_##name))
+
+/** @brief Little-endian u16 from the reply data (after command, sequence, status). */
+#define REPLY_U16(offset) (reply[3 + (offset)] | (reply[4 + (offset)] << 8))
+
+/**
+ * @brief PWM/DIR mode at 20 kHz, stopped, parser and USART1 idle.
+ */
+static void setup() {
+    MOCK_Reset();
+    CLOCK_INHF_clock_init();
+    TLE9201SG_OFF();
+    RAMP_Reset();
+    TLE9201SG.pwm_freq = 20000;
+    TLE9201SG.duty_cycle = PWM_DUTY_PERCENT(30);
+    TLE9201SG_Mode_init(TLE9201SG_MODE_PWMDIR);
+    USART1_init();
+    run();
+    tx_length = 0;
+    COMMAND.errors = 0;
+}
+
+/**
+ * @brief The COBS decoder restores zeros and rejects malformed frames.
+ */
+static void test_decode() {
+    uint8_t frame[] = { 0x03, 0x11, 0x22, 0x02, 0x33, 0x01 };
+    CHECK_EQUAL(5, COMMAND_Decode(frame, sizeof(frame)));
+    CHECK_EQUAL(0x11, frame[0]);
+    CHECK_EQUAL(0x00, frame[2]);
+    CHECK_EQUAL(0x33, frame[3]);
+    CHECK_EQUAL(0x00, frame[4]);
+
+    uint8_t zero[] = { 0x02, 0x11, 0x00, 0x01 };
+    CHECK_EQUAL(0, COMMAND_Decode(zero, sizeof(zero)));
+    uint8_t past_end[] = { 0x05, 0x11, 0x22 };
+    CHECK_EQUAL(0, COMMAND_Decode(past_end, sizeof(past_end)));
+}
+
+/**
+ * @brief Every command answers with its sequence number and the expected status and data.
+ */
+static void test_commands() {
+    setup();
+
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(SET_DUTY));
+    CHECK_EQUAL(SEQ_SET_DUTY, reply[1]);
+    CHECK_EQUAL(3, reply_length);
+    CHECK_EQUAL(0x8000, TLE9201SG.duty_cycle);
+    CHECK_EQUAL(COMMAND_INVALID, TRANSACT(SET_DUTY_SHORT));
+    CHECK_EQUAL(SEQ_SET_DUTY_SHORT, reply[1]);
+
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(SET_FREQ));
+    CHECK_EQUAL(10000, TLE9201SG.pwm_freq);
+    CHECK_EQUAL(COMMAND_INVALID, TRANSACT(SET_FREQ_ZERO));
+
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(DIR));
+    CHECK_EQUAL(1, GET_BIT(PORTD.OUT, PIN5_bp));
+    CHECK_EQUAL(COMMAND_INVALID, TRANSACT(DIR_INVALID));
+
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(START));
+    CHECK(TLE9201SG_Running());
+    CHECK_EQUAL(COMMAND_BUSY, TRANSACT(MODE_SPI)); // Outputs running
+
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(READ));
+    CHECK_EQUAL(3 + 11, reply_length);
+    CHECK_EQUAL(TLE9201SG_MODE_PWMDIR, reply[3]);
+    CHECK_EQUAL(0, reply[7]);        // Fault
+    CHECK_EQUAL(1, reply[8]);        // Running
+    CHECK_EQUAL(1, reply[9]);        // Direction
+    CHECK_EQUAL(10000, REPLY_U16(7));
+    CHECK_EQUAL(0x8000, REPLY_U16(9));
+
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(STOP));
+    TLE9201SG_OFF(); // Skip the braking ramp
+    RAMP_Reset();
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(MODE_SPI));
+    CHECK_EQUAL(TLE9201SG_MODE_SPI, TLE9201SG.mode);
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(MODE_PWM));
+    CHECK_EQUAL(TLE9201SG_MODE_PWMDIR, TLE9201SG.mode);
+
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(TELEMETRY));
+
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(FAULTS));
+    CHECK_EQUAL(3 + 2 * DIAG_CLASSES, reply_length);
+
+    DIAG_Log.head = 0; // HISTORY asks for entry 0
+    CHECK_EQUAL(COMMAND_INVALID, TRANSACT(HISTORY)); // Not written yet
+    CHECK_EQUAL(3 + 2, reply_length);
+    RTC_Ticks = 0x12345678;
+    DIAG_Record_Latch(1);
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(HISTORY));
+    CHECK_EQUAL(3 + 8, reply_length);
+    CHECK_EQUAL(1, reply[3]);                // Head
+    CHECK_EQUAL(DIAG_LOG_SIZE, reply[4]);
+    CHECK_EQUAL(0x5678, REPLY_U16(2));       // Ticks, little-endian
+    CHECK_EQUAL(0x1234, REPLY_U16(4));
+    CHECK_EQUAL(1, reply[9]);                // Latch tripped
+    CHECK_EQUAL(DIAG_SOURCE_TCD, reply[10]);
+    for (uint8_t i = 0; i < DIAG_LOG_SIZE; i++) {
+        DIAG_Record_Latch(0);
+    }
+    CHECK_EQUAL(COMMAND_INVALID, TRANSACT(HISTORY)); // Overwritten
+    CHECK_EQUAL(3 + 2, reply_length);
+    CHECK_EQUAL(1 + DIAG_LOG_SIZE, reply[3]);
+
+#ifdef PROFILE
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(PROFILE));
+    CHECK_EQUAL(3 + 8, reply_length);
+#else
+    CHECK_EQUAL(COMMAND_UNKNOWN, TRANSACT(PROFILE));
+#endif
+#ifdef JITTER
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(JITTER));
+    CHECK_EQUAL(3 + 10, reply_length);
+#else
+    CHECK_EQUAL(COMMAND_UNKNOWN, TRANSACT(JITTER));
+#endif
+    CHECK_EQUAL(COMMAND_UNKNOWN, TRANSACT(UNKNOWN));
+    CHECK_EQUAL(0x42 | COMMAND_REPLY, reply[0]);
+
+    CHECK_EQUAL(0, COMMAND.errors);
+    CHECK_EQUAL(0, tx_length); // Nothing but the replies was sent
+}
+
+/**
+ * @brief A request with a broken CRC gets no reply and counts as an error.
+ */
+static void test_bad_crc() {
+    setup();
+    uint8_t frame[sizeof(FRAME_READ)];
+    memcpy(frame, FRAME_READ, sizeof(frame));
+    frame[sizeof(frame) - 2] ^= 0x01; // Last CRC byte
+
+    CHECK_EQUAL(0xFF, transact(frame, sizeof(frame)));
+    CHECK_EQUAL(1, COMMAND.errors);
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(READ)); // Next request is fine
+    CHECK_EQUAL(1, COMMAND.errors);
+}
+
+/**
+ * @brief A frame longer than COMMAND_FRAME_SIZE is dropped up to its delimiter.
+ */
+static void test_oversize() {
+    setup();
+    uint8_t frame[COMMAND_FRAME_SIZE + 4];
+    memset(frame, 0x55, sizeof(frame) - 1);
+    frame[sizeof(frame) - 1] = 0x00;
+
+    CHECK_EQUAL(0xFF, transact(frame, sizeof(frame)));
+    CHECK_EQUAL(1, COMMAND.errors);
+    CHECK_EQUAL(0, COMMAND.discard);
+    CHECK_EQUAL(COMMAND_OK, TRANSACT(READ));
+    CHECK_EQUAL(SEQ_READ, reply[1]);
+}
+
+/**
+ * @brief A receive buffer overflow drops the frame being received, the next one is fine.
+ */
+static void test_overflow() {
+    setup();
+    receive(FRAME_SET_DUTY, 4); // Start of a request
+    run();
+    CHECK_EQUAL(3, COMMAND.length);
+
+    uint8_t noise[USART1_RX_SIZE + 8];
+    memset(noise, 0x55, sizeof(noise));
+    receive(noise, sizeof(noise)); // Main loop stalled, bytes lost
+    CHECK_EQUAL(1, USART1_Rx.overflow);
+    run();
+    CHECK_EQUAL(1, COMMAND.errors);
+    CHECK_EQUAL(1, COMMAND.discard);
+    CHECK_EQUAL(0, tx_length);
+
+    uint8_t status = TRANSACT(READ); // Its leading delimiter ends the broken frame
+    CHECK_EQUAL(COMMAND_OK, status);
+    CHECK_EQUAL(SEQ_READ, reply[1]);
+    CHECK(TLE9201SG.duty_cycle != 0x8000); // SET_DUTY never ran
+}
+
+int main(void) {
+    TEST_RUN(test_decode);
+    TEST_RUN(test_commands);
+    TEST_RUN(test_bad_crc);
+    TEST_RUN(test_oversize);
+    TEST_RUN(test_overflow);
+    return TEST_Result("test_command");
+}
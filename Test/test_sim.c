@@ -0,0 +1,365 @@
+/**
+ * @file test_sim.c
+ * @brief Host tests of the SPI-mode response handling against the TLE9201SG model.
+ *
+ * @details Faults are injected with TLE9201SG_Sim_Inject() and the SPI-mode PWM edges
+ *          are raised by calling the TCB0 interrupt handler. Every answer arrives one
+ *          frame late, so an injected fault shows up with the second edge after it.
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+#include "test.h"
+
+void TCB0_INT_vect(void); ///< SPI-mode PWM edge (TLE9201SG.c)
+void TCD0_TRIG_vect(void); ///< PWM/DIR-mode fault input (TLE9201SG.c)
+void TCD0_OVF_vect(void); ///< PWM/DIR-mode period end, takes the committed compare values (TCD.c)
+
+/** @brief Frames counted by the model for one command. */
+#define SIM_FRAMES(command) (TLE9201SG_Sim.frames[(command) >> 5])
+
+/** @brief Diagnosis byte of the model with the outputs enabled and no failure. */
+#define SIM_DIAG_OK (TLE9201SG_SIM_EN_bm | TLE9201SG_SIM_DIA_OK)
+
+/** @brief SPWM bit of the model's control byte. */
+#define SIM_SPWM 0x01
+
+/** @brief SDIR bit of the model's control byte. */
+#define SIM_SDIR 0x02
+
+/**
+ * @brief Level of the DIS pin (PD6) after the last driver call.
+ *
+ * @details The mock port does not fold OUTSET/OUTCLR into OUT; this does, once per
+ *          call, so it must be read after every step that may touch the pin.
+ */
+static uint8_t dis_pin() {
+    PORTD.OUT = (PORTD.OUT | PORTD.OUTSET) & ~PORTD.OUTCLR;
+    PORTD.OUTSET = 0;
+    PORTD.OUTCLR = 0;
+    return GET_BIT(PORTD.OUT, PIN6_bp);
+}
+
+/**
+ * @brief Starts SPI mode at 20 kHz on the reset model and checks the initialization frames.
+ */
+static void setup() {
+    MOCK_Reset();
+    CLOCK_INHF_clock_init();
+    TLE9201SG_Sim_Reset();
+    TLE9201SG.diag = 0;
+    TLE9201SG.revision = 0;
+    TLE9201SG.dirty = 0;
+    TLE9201SG.pwm_freq = 20000;
+    TLE9201SG.duty_cycle = PWM_DUTY_PERCENT(50);
+    TLE9201SG_Mode_init(TLE9201SG_MODE_SPI);
+
+    // WR_CTRL answered by RD_REV, the revision is still on its way
+    CHECK_EQUAL(1, SIM_FRAMES(WR_CTRL));
+    CHECK_EQUAL(1, SIM_FRAMES(RD_REV));
+    CHECK_EQUAL(TLE9201SG_Sim.control, TLE9201SG.control);
+    CHECK_EQUAL(1, TLE9201SG.SIN);
+    CHECK_EQUAL(0, TLE9201SG.SEN);
+    CHECK_EQUAL(0, TLE9201SG.revision);
+    CHECK_EQUAL(RD_REV, TLE9201SG.pending);
+}
+
+/**
+ * @brief The revision arrives with the first PWM frame, the diagnosis with the second.
+ */
+static void test_start() {
+    setup();
+    TLE9201SG_START();
+    CHECK_EQUAL(0x22, TLE9201SG.revision);
+    CHECK_EQUAL(TLE9201SG_SIM_REVISION, TLE9201SG.revision);
+    CHECK_EQUAL(1, SIM_FRAMES(WR_CTRL_RD_DIA));
+    CHECK(TLE9201SG_Sim.control & TLE9201SG_SIM_SEN_bm);
+    CHECK_EQUAL(0, TLE9201SG_Sim.control & SIM_SPWM); // Soft start at zero duty
+    CHECK_EQUAL(0, TLE9201SG.diag);
+
+    TCB0_INT_vect(); // On phase ends
+    CHECK_EQUAL(2, SIM_FRAMES(WR_CTRL_RD_DIA));
+    CHECK_EQUAL(SIM_DIAG_OK, TLE9201SG.diag);
+    CHECK_EQUAL(1, TLE9201SG.EN);
+    CHECK_EQUAL(0, TLE9201SG_Fault_Status());
+    CHECK_EQUAL(0, TLE9201SG.dirty);
+    CHECK_EQUAL(TLE9201SG.off, TCB0.CCMP);
+    CHECK_EQUAL(0, TLE9201SG.SPWM);
+}
+
+/**
+ * @brief Zero duty keeps SPWM off through the on phases, the period keeps running.
+ */
+static void test_zero_duty() {
+    setup();
+    TLE9201SG_START();
+    CHECK_EQUAL(1, TLE9201SG.hold);
+    CHECK_EQUAL(TLE9201SG.on, TCB0.CCMP);
+    for (uint8_t edge = 0; edge < 3; edge++) {
+        TCB0_INT_vect();
+        CHECK_EQUAL(0, TLE9201SG_Sim.control & SIM_SPWM);
+    }
+    CHECK_EQUAL(TLE9201SG.off, TCB0.CCMP); // Still alternating the phases
+
+    TLE9201SG_Drive(PWM_DUTY_PERCENT(50));
+    CHECK_EQUAL(0, TLE9201SG.hold);
+    TCB0_INT_vect(); // Off phase ended
+    CHECK_EQUAL(SIM_SPWM, TLE9201SG_Sim.control & SIM_SPWM);
+    CHECK_EQUAL(TLE9201SG.on, TCB0.CCMP);
+
+    TLE9201SG_Drive(0);
+    TCB0_INT_vect(); // On phase ended
+    TCB0_INT_vect(); // Next on phase is held off
+    CHECK_EQUAL(0, TLE9201SG_Sim.control & SIM_SPWM);
+    CHECK_EQUAL(TLE9201SG.on, TCB0.CCMP);
+    CHECK_EQUAL(1, TLE9201SG.phase);
+    CHECK_EQUAL(7, SIM_FRAMES(WR_CTRL_RD_DIA)); // Diagnosis still polled every edge
+}
+
+/**
+ * @brief A direction change flips SDIR only after a frame has held SPWM off.
+ */
+static void test_reverse() {
+    setup();
+    RAMP_set_slew(0, 0, 0); // Whole steps, one tick each
+    RAMP_set_deadtime(2);
+    TLE9201SG_START();
+    RAMP_Tick();
+    CHECK_EQUAL(0, TLE9201SG.hold);
+    TCB0_INT_vect();
+    TCB0_INT_vect(); // On phase, driving
+    CHECK_EQUAL(SIM_SPWM, TLE9201SG_Sim.control & SIM_SPWM);
+    uint8_t sdir = TLE9201SG_Sim.control & SIM_SDIR;
+
+    TLE9201SG_DIR(!TLE9201SG.SDIR);
+    RAMP_Tick(); // Down to zero, dead time starts
+    CHECK_EQUAL(1, TLE9201SG.hold);
+    CHECK_EQUAL(RAMP_DEADTIME, RAMP.state);
+    RAMP_Tick();
+    RAMP_Tick();
+    RAMP_Tick(); // Dead time over, but the on phase frame still drives
+    CHECK_EQUAL(RAMP_DEADTIME, RAMP.state);
+    CHECK_EQUAL(sdir, TLE9201SG_Sim.control & SIM_SDIR);
+
+    TCB0_INT_vect(); // On phase ended
+    TCB0_INT_vect(); // Held off
+    CHECK_EQUAL(0, TLE9201SG_Sim.control & SIM_SPWM);
+    RAMP_Tick(); // Flips and ramps back up
+    CHECK_EQUAL(0, RAMP.reverse);
+    CHECK_EQUAL(0, TLE9201SG.hold);
+    CHECK_EQUAL(sdir, TLE9201SG_Sim.control & SIM_SDIR); // Bridge stayed off until now
+    TCB0_INT_vect();
+    TCB0_INT_vect();
+    CHECK_EQUAL(sdir ^ SIM_SDIR, TLE9201SG_Sim.control & SIM_SDIR);
+    CHECK_EQUAL(SIM_SPWM, TLE9201SG_Sim.control & SIM_SPWM);
+}
+
+/**
+ * @brief In PWM/DIR mode DIS holds the bridge off before DIR flips.
+ *
+ * @details Double slope still pulses once per period at zero duty, so the
+ *          dead time must not rely on the duty alone.
+ */
+static void test_reverse_pwm() {
+    setup();
+    TLE9201SG_OFF();
+    RAMP_Reset(); // Skip the ramp
+    CHECK(TLE9201SG_Set_Mode(TLE9201SG_MODE_PWMDIR));
+    RAMP_set_slew(0, 0, 0); // Whole steps, one tick each
+    RAMP_set_deadtime(2);
+    TLE9201SG_START();
+    CHECK_EQUAL(0, dis_pin());
+    RAMP_Tick();
+    TCD0_OVF_vect();
+    uint8_t dir = PORTD.OUT & PIN5_bm;
+
+    TLE9201SG_DIR(!dir);
+    RAMP_Tick(); // Down to zero, dead time starts
+    TCD0_OVF_vect();
+    CHECK_EQUAL(RAMP_DEADTIME, RAMP.state);
+    CHECK(TCD0.CMPASET != 0); // Zero duty alone still emits a pulse
+    CHECK_EQUAL(1, dis_pin()); // Outputs disabled
+    TLE9201SG_START(); // Restarting mid dead time keeps them disabled
+    CHECK_EQUAL(1, dis_pin());
+    RAMP_Tick();
+    RAMP_Tick();
+    CHECK_EQUAL(RAMP_DEADTIME, RAMP.state);
+    CHECK_EQUAL(dir, PORTD.OUT & PIN5_bm);
+    CHECK_EQUAL(1, dis_pin());
+
+    RAMP_Tick(); // Flips, enables and ramps back up
+    CHECK_EQUAL(0, RAMP.reverse);
+    CHECK_EQUAL(dir ^ PIN5_bm, PORTD.OUT & PIN5_bm);
+    CHECK_EQUAL(0, dis_pin());
+}
+
+/**
+ * @brief Over-temperature with a diagnosis code, one frame late.
+ */
+static void test_inject_ot() {
+    setup();
+    TLE9201SG_START();
+    TCB0_INT_vect();
+
+    TLE9201SG_Sim_Inject(TLE9201SG_SIM_OT_bm, 0x03);
+    TCB0_INT_vect(); // Answer was prepared before the fault
+    CHECK_EQUAL(SIM_DIAG_OK, TLE9201SG.diag);
+    CHECK_EQUAL(0, TLE9201SG_Fault_Status());
+
+    TCB0_INT_vect();
+    CHECK_EQUAL(TLE9201SG_SIM_EN_bm | TLE9201SG_SIM_OT_bm | 0x03, TLE9201SG.diag);
+    CHECK_EQUAL(1, TLE9201SG.OT);
+    CHECK_EQUAL(0x03, TLE9201SG.DIA);
+    CHECK_EQUAL(1, TLE9201SG.dirty);
+    CHECK_EQUAL(0x03, TLE9201SG_Fault_Status());
+    CHECK_EQUAL(0, TLE9201SG.dirty);
+    CHECK_EQUAL(4, SIM_FRAMES(WR_CTRL_RD_DIA));
+    CHECK_EQUAL(6, TLE9201SG_Sim.total);
+}
+
+/**
+ * @brief Current limit alone is a flag, not a fault; the control byte is not touched.
+ */
+static void test_inject_cl() {
+    setup();
+    uint8_t control = TLE9201SG.control;
+    TLE9201SG_START();
+    TCB0_INT_vect();
+
+    TLE9201SG_Sim_Inject(TLE9201SG_SIM_CL_bm, TLE9201SG_SIM_DIA_OK);
+    TCB0_INT_vect();
+    CHECK_EQUAL(0, TLE9201SG.CL);
+    TCB0_INT_vect();
+    CHECK_EQUAL(1, TLE9201SG.CL);
+    CHECK_EQUAL(0, TLE9201SG.OT);
+    CHECK_EQUAL(TLE9201SG_DIA_OK, TLE9201SG.DIA);
+    CHECK_EQUAL(0, TLE9201SG_Fault_Status());
+
+    // Only RD_CTRL and WR_CTRL answers are stored in the control byte
+    CHECK_EQUAL(control | TLE9201SG_SIM_SEN_bm, TLE9201SG.control & ~1);
+    CHECK_EQUAL(0, SIM_FRAMES(RD_CTRL));
+}
+
+/**
+ * @brief A diagnosis code alone, then cleared by RES_DIA.
+ */
+static void test_inject_dia() {
+    setup();
+    TLE9201SG_START();
+    TCB0_INT_vect();
+
+    TLE9201SG_Sim_Inject(0, 0x0C);
+    TCB0_INT_vect();
+    TCB0_INT_vect();
+    CHECK_EQUAL(0x0C, TLE9201SG.DIA);
+    CHECK_EQUAL(0, TLE9201SG.OT | TLE9201SG.TV | TLE9201SG.CL);
+    CHECK_EQUAL(0x0C, TLE9201SG_Fault_Status());
+
+    TLE9201SG_Send(RES_DIA); // Answers the fault once more, then clears it
+    CHECK_EQUAL(1, SIM_FRAMES(RES_DIA));
+    TCB0_INT_vect();
+    CHECK_EQUAL(0x0C, TLE9201SG.DIA);
+    TCB0_INT_vect();
+    CHECK_EQUAL(SIM_DIAG_OK, TLE9201SG.diag);
+    CHECK_EQUAL(0, TLE9201SG_Fault_Status());
+}
+
+/**
+ * @brief The SPI diagnosis and the TCD0 fault latch are kept apart across mode switches.
+ */
+static void test_fault_sources() {
+    setup();
+    DIAG_init();
+    TLE9201SG_START();
+    TCB0_INT_vect();
+    TLE9201SG_Sim_Inject(0, 0x0C);
+    TCB0_INT_vect();
+    TCB0_INT_vect();
+    CHECK_EQUAL(1, TLE9201SG.dirty); // Not derived yet when the mode changes
+    TLE9201SG_OFF();
+    RAMP_Reset(); // Skip the ramp
+
+    CHECK(TLE9201SG_Set_Mode(TLE9201SG_MODE_PWMDIR));
+    CHECK_EQUAL(0, TLE9201SG.dirty);
+    CHECK_EQUAL(0, TLE9201SG_Fault_Status());
+    CHECK_EQUAL(0, TLE9201SG.Fault);
+
+    uint8_t head = DIAG_Log.head;
+    uint16_t count[DIAG_CLASSES];
+    DIAG_Counters(count);
+    TCD0_TRIG_vect(); // Fault flag raised while driving in PWM/DIR mode
+    TCD0_TRIG_vect(); // Still the same fault
+    CHECK_EQUAL(1, TLE9201SG_Fault_Status());
+    CHECK_EQUAL(0, TLE9201SG.Fault);
+    TLE9201SG_START(); // Fault flag (PA5) is low again, recovers
+    CHECK_EQUAL(0, TLE9201SG_Fault_Status());
+    CHECK(TLE9201SG_Running());
+
+    // Onset and recovery are logged, the onset is counted once
+    DIAG_ENTRY entry;
+    CHECK_EQUAL((uint8_t)(head + 2), DIAG_Log.head);
+    CHECK(DIAG_Get(head, &entry));
+    CHECK_EQUAL(DIAG_SOURCE_TCD, entry.source);
+    CHECK_EQUAL(1, entry.diag);
+    CHECK(DIAG_Get(head + 1, &entry));
+    CHECK_EQUAL(DIAG_SOURCE_TCD, entry.source);
+    CHECK_EQUAL(0, entry.diag);
+    uint16_t after[DIAG_CLASSES];
+    DIAG_Counters(after);
+    CHECK_EQUAL(count[DIAG_CLASS_TCD] + 1, after[DIAG_CLASS_TCD]);
+    CHECK_EQUAL(count[DIAG_CLASS_DIA], after[DIAG_CLASS_DIA]);
+
+    TCD0_TRIG_vect();
+    TLE9201SG_OFF();
+    RAMP_Reset();
+    CHECK(TLE9201SG_Set_Mode(TLE9201SG_MODE_SPI));
+    CHECK_EQUAL(0, TLE9201SG_Fault_Status()); // Latch belongs to PWM/DIR mode
+    CHECK_EQUAL(0, TLE9201SG.latched);
+    CHECK_EQUAL(0, EVSYS.USERTCD0INPUTA);      // PA5 is MISO, not the fault input
+    CHECK_EQUAL(0, TCD0.INTCTRL & TCD_TRIGA_bm);
+    CHECK_EQUAL(0, GET_BIT(PORTD.OUT, PIN6_bp));
+
+    // A stray TRIGA in SPI mode neither disables the bridge nor is logged
+    head = DIAG_Log.head;
+    DIAG_Counters(count);
+    TCD0_TRIG_vect();
+    CHECK_EQUAL(0, TLE9201SG.latched);
+    CHECK_EQUAL(0, GET_BIT(PORTD.OUT, PIN6_bp));
+    CHECK_EQUAL(head, DIAG_Log.head);
+    DIAG_Counters(after);
+    CHECK_EQUAL(count[DIAG_CLASS_TCD], after[DIAG_CLASS_TCD]);
+
+    CHECK(TLE9201SG_Set_Mode(TLE9201SG_MODE_PWMDIR)); // Routed again
+    CHECK_EQUAL(EVSYS_USER_CHANNEL0_gc, EVSYS.USERTCD0INPUTA);
+    CHECK(TCD0.INTCTRL & TCD_TRIGA_bm);
+}
+
+/**
+ * @brief Stopping sends one more control frame with SEN and SPWM cleared.
+ */
+static void test_off() {
+    setup();
+    TLE9201SG_START();
+    TCB0_INT_vect();
+    uint16_t frames = SIM_FRAMES(WR_CTRL_RD_DIA);
+
+    TLE9201SG_OFF();
+    CHECK_EQUAL(frames + 1, SIM_FRAMES(WR_CTRL_RD_DIA));
+    CHECK_EQUAL(0, TLE9201SG_Sim.control & (TLE9201SG_SIM_SEN_bm | 1));
+    CHECK_EQUAL(0, TLE9201SG_Running());
+}
+
+int main(void) {
+    TEST_RUN(test_start);
+    TEST_RUN(test_zero_duty);
+    TEST_RUN(test_reverse);
+    TEST_RUN(test_reverse_pwm);
+    TEST_RUN(test_inject_ot);
+    TEST_RUN(test_inject_cl);
+    TEST_RUN(test_inject_dia);
+    TEST_RUN(test_off);
+    TEST_RUN(test_fault_sources);
+    return TEST_Result("test_sim");
+}
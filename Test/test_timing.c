@@ -0,0 +1,171 @@
+/**
+ * @file test_timing.c
+ * @brief Host tests of the PWM timing math: TLE9201SG_SPI_Timing() and PWM_Compare().
+ *
+ * @details The clock tree comes from the real clock initialization running on the
+ *          mock CLKCTRL registers (24 MHz OSCHF, 48 MHz PLL).
+ *
+ * @author Saulius
+ * @date 2025-01-10
+ */
+
+#include "Settings.h"
+#include "test.h"
+
+/**
+ * @brief Resets the registers and decodes a 24 MHz OSCHF / 48 MHz PLL clock tree.
+ */
+static void setup() {
+    MOCK_Reset();
+    CLOCK_INHF_clock_init();
+    PLL_init();
+}
+
+/**
+ * @brief 20 kHz from CLK_PER: 1200 ticks per period, phases clamped to 336 ticks (14 us).
+ */
+static void test_spi_timing_20khz() {
+    setup();
+    TLE9201SG.pwm_freq = 20000;
+
+    CHECK_EQUAL(TCB_CLKSEL_DIV1_gc, TLE9201SG_SPI_Timing(0x8000));
+    CHECK_EQUAL(599, TLE9201SG.on);
+    CHECK_EQUAL(599, TLE9201SG.off);
+
+    TLE9201SG_SPI_Timing(PWM_DUTY_PERCENT(40)); // 479.99 ticks on, rounded down
+    CHECK_EQUAL(478, TLE9201SG.on);
+    CHECK_EQUAL(720, TLE9201SG.off);
+
+    TLE9201SG_SPI_Timing(PWM_DUTY_PERCENT(10)); // 120 ticks, shorter than one frame
+    CHECK_EQUAL(335, TLE9201SG.on);
+    CHECK_EQUAL(863, TLE9201SG.off);
+
+    TLE9201SG_SPI_Timing(PWM_DUTY_PERCENT(90)); // Off phase needs the frame time too
+    CHECK_EQUAL(863, TLE9201SG.on);
+    CHECK_EQUAL(335, TLE9201SG.off);
+}
+
+/**
+ * @brief Periods beyond 16 bits halve the TCB0 clock, beyond that they are capped.
+ */
+static void test_spi_timing_slow() {
+    setup();
+    TLE9201SG.pwm_freq = 1000; // 24000 ticks
+    CHECK_EQUAL(TCB_CLKSEL_DIV1_gc, TLE9201SG_SPI_Timing(0x8000));
+    CHECK_EQUAL(11999, TLE9201SG.on);
+    CHECK_EQUAL(11999, TLE9201SG.off);
+
+    TLE9201SG.pwm_freq = 200; // 120000 ticks, 60000 at CLK_PER/2
+    CHECK_EQUAL(TCB_CLKSEL_DIV2_gc, TLE9201SG_SPI_Timing(0x8000));
+    CHECK_EQUAL(29999, TLE9201SG.on);
+    CHECK_EQUAL(29999, TLE9201SG.off);
+    TLE9201SG_SPI_Timing(PWM_DUTY_PERCENT(0)); // 14 us are 168 ticks at CLK_PER/2
+    CHECK_EQUAL(167, TLE9201SG.on);
+    CHECK_EQUAL(1, TLE9201SG.hold);                // But SPWM is held off at zero duty
+    TLE9201SG_SPI_Timing(1);
+    CHECK_EQUAL(0, TLE9201SG.hold);
+
+    TLE9201SG.pwm_freq = 100; // Still too long at CLK_PER/2
+    CHECK_EQUAL(TCB_CLKSEL_DIV2_gc, TLE9201SG_SPI_Timing(0x8000));
+    CHECK_EQUAL(0xFFFF, (uint32_t)TLE9201SG.on + TLE9201SG.off + 2);
+}
+
+/**
+ * @brief Too fast for two frames per period: the duty stays centred.
+ */
+static void test_spi_timing_fast() {
+    setup();
+    TLE9201SG.pwm_freq = 50000; // 480 ticks, 336 minimum would not fit twice
+    TLE9201SG_SPI_Timing(PWM_DUTY_PERCENT(10));
+    CHECK_EQUAL(239, TLE9201SG.on);
+    CHECK_EQUAL(239, TLE9201SG.off);
+}
+
+/**
+ * @brief Double slope: CMPASET is the on-time plus one, the fraction is kept for dithering.
+ */
+static void test_pwm_compare_double_slope() {
+    setup();
+    TCD0_PWM.wgmode = TCD_WGMODE_DS_gc;
+
+    PWM_Compare(599, 0x8000); // 299.5 counts
+    CHECK_EQUAL(599, TCD0.CMPBCLR);
+    CHECK_EQUAL(300, TCD0.CMPASET);
+    CHECK_EQUAL(298, TCD0.CMPBSET);
+    CHECK_EQUAL(300, TCD0_PWM.count);
+    CHECK_EQUAL(0x8000, TCD0_PWM.fraction);
+
+    PWM_Compare(599, PWM_DUTY_PERCENT(10)); // 599 * 6553 / 65536 = 59.89
+    CHECK_EQUAL(60, TCD0.CMPASET);
+    CHECK_EQUAL(538, TCD0.CMPBSET);
+    CHECK_EQUAL(58623, TCD0_PWM.fraction);
+}
+
+/**
+ * @brief One ramp: WOA set at the start of the ramp and cleared at CMPACLR.
+ */
+static void test_pwm_compare_one_ramp() {
+    setup();
+    TCD0_PWM.wgmode = TCD_WGMODE_ONERAMP_gc;
+
+    PWM_Compare(1199, 0x4000); // A quarter of 1200 counts
+    CHECK_EQUAL(1199, TCD0.CMPBCLR);
+    CHECK_EQUAL(0, TCD0.CMPASET);
+    CHECK_EQUAL(300, TCD0.CMPACLR);
+    CHECK_EQUAL(0, TCD0_PWM.fraction);
+}
+
+/**
+ * @brief The smallest prescaler that keeps the period within 12 bits is chosen.
+ */
+static void test_pwm_prescaler() {
+    setup();
+    CHECK_EQUAL(TCD_SYNCPRES_DIV1_gc | TCD_CNTPRES_DIV1_gc,
+                PWM_prescaler(CLOCK_Tree.oschf, 20000, TCD_WGMODE_DS_gc)); // 600 counts
+    CHECK_EQUAL(TCD_SYNCPRES_DIV1_gc | TCD_CNTPRES_DIV4_gc,
+                PWM_prescaler(CLOCK_Tree.oschf, 1000, TCD_WGMODE_DS_gc));  // 12000 counts at DIV1
+    CHECK_EQUAL(TCD_SYNCPRES_DIV2_gc | TCD_CNTPRES_DIV4_gc,
+                PWM_prescaler(CLOCK_Tree.pll, 1000, TCD_WGMODE_DS_gc));    // 24000 counts at DIV1
+    CHECK_EQUAL(TCD_SYNCPRES_DIV4_gc | TCD_CNTPRES_DIV4_gc,
+                PWM_prescaler(CLOCK_Tree.pll, 1000, TCD_WGMODE_ONERAMP_gc)); // 48000 counts, one ramp
+    CHECK_EQUAL(TCD_SYNCPRES_DIV8_gc | TCD_CNTPRES_DIV32_gc,
+                PWM_prescaler(CLOCK_Tree.pll, 1, TCD_WGMODE_DS_gc));       // Nothing fits, largest
+
+    // 1 kHz from the PLL now fits CMPBCLR
+    TCD0.CTRLB = TCD_WGMODE_DS_gc;
+    TCD0.CTRLA = TCD_CLKSEL_PLL_gc | PWM_prescaler(CLOCK_Tree.pll, 1000, TCD_WGMODE_DS_gc);
+    CLOCK_update();
+    PWM_init(1000, PWM_DUTY_PERCENT(10));
+    CHECK_EQUAL(2999, TCD0.CMPBCLR);
+    CHECK(TCD0.CMPBCLR <= TCD_PERIOD_MAX);
+}
+
+/**
+ * @brief PWM/DIR mode initialization plans the PLL at 20 kHz and loads the compare values.
+ */
+static void test_pwm_mode_init() {
+    setup();
+    TLE9201SG.pwm_freq = 20000;
+    TLE9201SG.duty_cycle = PWM_DUTY_PERCENT(30);
+    TLE9201SG_Mode_init(TLE9201SG_MODE_PWMDIR);
+
+    CHECK_EQUAL(48000000UL, CLOCK_Tree.pll);
+    CHECK_EQUAL(48000000UL, CLOCK_read());
+    CHECK_EQUAL(TCD_CLKSEL_PLL_gc, TCD0.CTRLA & TCD_CLKSEL_gm);
+    CHECK_EQUAL(TCD_WGMODE_DS_gc, TCD0.CTRLB);
+    CHECK_EQUAL(1199, TCD0.CMPBCLR); // 48 MHz / (2 * 20 kHz) - 1
+    CHECK_EQUAL(360, TCD0.CMPASET);  // 1199 * 0.3 rounded down, plus one
+    CHECK_EQUAL(838, TCD0.CMPBSET);
+    CHECK_EQUAL(0, PWM_pending());   // Stopped timer takes the values when enabled
+}
+
+int main(void) {
+    TEST_RUN(test_spi_timing_20khz);
+    TEST_RUN(test_spi_timing_slow);
+    TEST_RUN(test_spi_timing_fast);
+    TEST_RUN(test_pwm_compare_double_slope);
+    TEST_RUN(test_pwm_compare_one_ramp);
+    TEST_RUN(test_pwm_prescaler);
+    TEST_RUN(test_pwm_mode_init);
+    return TEST_Result("test_timing");
+}
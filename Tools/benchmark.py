@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Reads the AVR64DD32-TLE9201SG benchmark results (Benchmark.c, BENCHMARK builds).
+
+Waits for one complete report over USART1, prints every case against its
+baseline and exits with status 1 if a case is slower than its baseline plus
+the tolerance, or if no complete report arrives in time. Cases with a
+baseline of 0 are not checked; --update records the measured cycles.
+
+    benchmark.py /dev/ttyUSB0
+    benchmark.py --update ../AVR64DD32-TLE9201SG/BenchmarkVar.h /dev/ttyUSB0
+"""
+
+import argparse
+import os
+import re
+import select
+import struct
+import sys
+import time
+
+from telemetry import cobs_decode, crc16, open_port
+
+TYPE_CASE = 0x02
+TYPE_SUMMARY = 0x03
+CASE = struct.Struct("<BBBBBIHHH")
+SUMMARY = struct.Struct("<BBBBHHHH")
+FUNCTIONS = ("PWM_INIT", "PWM_SET_DUTY", "CLOCK_UPDATE", "CLOCK_READ", "SORT_DIAGNOSIS",
+             "WRITE", "START", "STOP", "SPI_EXCHANGE", "CURRENT_STEP", "PID_STEP")
+CLOCKS = {0x00: "OSCHF", 0x20: "PLL"}
+STATUS = ("RUNNING", "PASS", "FAIL")
+ROW = re.compile(r"^(\s*\{ BENCHMARK_(\w+),\s+\w+,\s+\w+,\s+.+?,\s+)(\d+)(, \d+ \},?)$")
+
+
+def frames(fd, timeout):
+    """Yields decoded payloads with a good CRC until the timeout."""
+    buffer = bytearray()
+    deadline = time.monotonic() + timeout
+    while True:
+        left = deadline - time.monotonic()
+        if left <= 0 or not select.select([fd], [], [], left)[0]:
+            return
+        chunk = os.read(fd, 256)
+        if not chunk:
+            return
+        buffer += chunk
+        while 0 in buffer:
+            end = buffer.index(0)
+            frame, buffer = bytes(buffer[:end]), buffer[end + 1:]
+            data = cobs_decode(frame) if frame else None
+            if data is None or len(data) < 3:
+                continue
+            payload, crc = data[:-2], struct.unpack("<H", data[-2:])[0]
+            if crc16(payload) == crc:
+                yield payload
+
+
+def collect(fd, timeout):
+    """Returns (cases, summary) of the first complete report, or None."""
+    cases = {}
+    for payload in frames(fd, timeout):
+        if payload[0] == TYPE_CASE and len(payload) == CASE.size:
+            case = CASE.unpack(payload)
+            cases[case[1]] = case
+        elif payload[0] == TYPE_SUMMARY and len(payload) == SUMMARY.size and cases:
+            count = next(iter(cases.values()))[2]
+            if sorted(cases) == list(range(count)):
+                return [cases[i] for i in range(count)], SUMMARY.unpack(payload)
+            cases = {}  # Joined in the middle of a report, wait for the next one
+    return None
+
+
+def show(cases, summary):
+    _, status, regressions, tolerance, overhead, stack, flash, ram = summary
+    failed = 0
+    print("  # function        clock    freq  param baseline cycles")
+    for _, index, _, function, clock, freq, param, baseline, cycles in cases:
+        slow = baseline and cycles * 100 > baseline * (100 + tolerance)
+        failed += bool(slow)
+        name = FUNCTIONS[function] if function < len(FUNCTIONS) else str(function)
+        print("%3d %-15s %-5s %7d 0x%04X %8d %6d %s" % (
+            index, name, CLOCKS.get(clock, clock), freq, param, baseline, cycles,
+            "FAIL" if slow else "PASS" if baseline else "-"))
+    print("status=%s regressions=%d tolerance=%d%% overhead=%d stack=%dB flash=%dB ram=%dB" % (
+        STATUS[status] if status < len(STATUS) else status, regressions, tolerance,
+        overhead, stack, flash, ram))
+    if not any(case[7] for case in cases):
+        print("no baselines recorded, nothing was checked (record them with --update)", file=sys.stderr)
+    return failed == 0 and status == 1
+
+
+def update(path, cases):
+    """Writes the measured cycles into the baseline column of BenchmarkVar.h.
+
+    Rows of functions missing from the report (compiled out, e.g. CURRENT_STEP
+    without CURRENT_CONTROL) keep their baselines.
+    """
+    with open(path) as f:
+        lines = f.read().split("\n")
+    reported = {FUNCTIONS[case[3]] for case in cases if case[3] < len(FUNCTIONS)}
+    rows = [i for i, line in enumerate(lines) if ROW.match(line) and ROW.match(line).group(2) in reported]
+    if len(rows) != len(cases):
+        sys.exit("%s has %d cases, the report has %d" % (path, len(rows), len(cases)))
+    for i, case in zip(rows, cases):
+        head, _, baseline, tail = ROW.match(lines[i]).groups()
+        lines[i] = head + str(case[8]).rjust(len(baseline)) + tail
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("device", help="serial device or pty")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds to wait for a report")
+    parser.add_argument("--update", metavar="PATH", help="write the measured cycles into BenchmarkVar.h")
+    args = parser.parse_args()
+
+    report = collect(open_port(args.device, args.baud), args.timeout)
+    if report is None:
+        sys.exit("no complete benchmark report within %.1f s" % args.timeout)
+    ok = show(*report)
+    if args.update:
+        update(args.update, report[0])
+        print("baselines written to %s" % args.update)
+    elif not ok:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        sys.exit(1)
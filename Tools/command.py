@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""Sends commands to the AVR64DD32-TLE9201SG over its USART1 link (Command.c).
+
+    command.py /dev/ttyUSB0 read
+    command.py /dev/ttyUSB0 duty 30
+    command.py /dev/ttyUSB0 freq 20000
+    command.py /dev/ttyUSB0 dir 1
+    command.py /dev/ttyUSB0 start
+    command.py /dev/ttyUSB0 stop
+    command.py /dev/ttyUSB0 mode spi
+    command.py /dev/ttyUSB0 telemetry 0
+    command.py /dev/ttyUSB0 history
+    command.py /dev/ttyUSB0 faults
+    command.py /dev/ttyUSB0 profile [reset]
+    command.py /dev/ttyUSB0 jitter [reset] > jitter.csv
+
+Requests use the telemetry framing (CRC-16/CCITT-FALSE, COBS, 0x00 delimiter)
+and start with a delimiter too, which ends a frame broken by line noise.
+Telemetry frames arriving in between are skipped.
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import time
+
+from telemetry import cobs_decode, cobs_encode, crc16, open_port
+
+(SET_DUTY, SET_FREQ, START, STOP, DIR, MODE, READ, TELEMETRY, HISTORY, FAULTS, PROFILE,
+ JITTER) = range(0x10, 0x1C)
+REPLY = 0x80
+STATUS = ("OK", "BUSY", "INVALID", "UNKNOWN")
+READ_DATA = struct.Struct("<BBBBBBBHH")
+FAULT_CLASSES = ("DIA", "CL", "TV", "OT", "TCD")
+PROFILE_REGIONS = ("START", "PWM_INIT", "SPI_COMPLETE", "CONTROL_TICK", "COMMAND_TASK", "TELEMETRY_TASK")
+RTC_TICK_HZ = 1024
+JITTER_SHIFT = 3
+sequence = int(time.monotonic() * 1000) & 0xFF
+
+
+def request(command, sequence, args=b""):
+    """Encodes one request. The leading delimiter ends any broken frame on the device."""
+    payload = bytes([command, sequence]) + args
+    return b"\0" + cobs_encode(payload + struct.pack("<H", crc16(payload)))
+
+
+def wait_reply(fd, command, sequence, timeout):
+    """Returns the reply payload after the status byte, raises on timeout."""
+    buffer = bytearray()
+    deadline = time.monotonic() + timeout
+    while True:
+        left = deadline - time.monotonic()
+        if left <= 0 or not select.select([fd], [], [], left)[0]:
+            raise TimeoutError("no reply")
+        buffer += os.read(fd, 256)
+        while 0 in buffer:
+            end = buffer.index(0)
+            frame, buffer = bytes(buffer[:end]), buffer[end + 1:]
+            data = cobs_decode(frame) if frame else None
+            if data is None or len(data) < 5 or crc16(data[:-2]) != struct.unpack("<H", data[-2:])[0]:
+                continue
+            if data[0] == command | REPLY and data[1] == sequence:
+                return data[2], data[3:-2]
+
+
+def transact(fd, command, data, timeout):
+    """Sends one request and returns (status, reply data)."""
+    global sequence
+    sequence = (sequence + 1) & 0xFF
+    os.write(fd, request(command, sequence, data))
+    return wait_reply(fd, command, sequence, timeout)
+
+
+def history(fd, timeout):
+    """Prints the kept diagnosis history entries, oldest first."""
+    status, reply = transact(fd, HISTORY, b"\0", timeout)
+    head, size = reply[0], reply[1]
+    for number in range(head - size, head):
+        status, reply = transact(fd, HISTORY, bytes([number & 0xFF]), timeout)
+        if status == 0:
+            ticks, diag, source = struct.unpack("<IBB", reply[2:8])
+            if source:
+                print("%3d %10.3fs tcd=%s" % (number & 0xFF, ticks / RTC_TICK_HZ, "fault" if diag else "recovered"))
+            else:
+                print("%3d %10.3fs diag=0x%02X" % (number & 0xFF, ticks / RTC_TICK_HZ, diag))
+    return 0
+
+
+def profile(fd, reset, timeout):
+    """Prints the profiled regions in CLK_PER cycles."""
+    for region, name in enumerate(PROFILE_REGIONS):
+        status, reply = transact(fd, PROFILE, bytes([region | (0x80 if reset else 0)]), timeout)
+        if status != 0:
+            print("%s (firmware built without PROFILE)" % STATUS[status] if status < len(STATUS) else status)
+            return 1
+        low, high, mean, count = struct.unpack("<4H", reply)
+        if count:
+            print("%-15s min=%5d max=%5d mean=%5d runs=%d" % (name, low, high, mean, count))
+        else:
+            print("%-15s not run" % name)
+    return 0
+
+
+def jitter(fd, reset, timeout):
+    """Prints the period and jitter histograms as CSV (bucket bounds in CLK_PER cycles)."""
+    pages = []
+    for page in (0, 1, 2):
+        status, reply = transact(fd, JITTER, bytes([page | (0x80 if reset and page == 2 else 0)]), timeout)
+        if status != 0:
+            print("%s (firmware built without JITTER)" % STATUS[status] if status < len(STATUS) else status,
+                  file=sys.stderr)
+            return 1
+        pages.append(reply)
+    count, nominal, low, high = struct.unpack("<IHHH", pages[0])
+    print("# periods=%d nominal=%d min=%d max=%d" % (count, nominal, low, high))
+    period = struct.unpack("<%dH" % (len(pages[1]) // 2), pages[1])
+    change = struct.unpack("<%dH" % (len(pages[2]) // 2), pages[2])
+    width = 1 << JITTER_SHIFT
+    half = len(period) // 2
+    print("deviation_from,deviation_to,periods,change_from,change_to,changes")
+    for i in range(len(period)):
+        print("%d,%d,%d,%d,%d,%d" % ((i - half) * width, (i - half + 1) * width - 1, period[i],
+                                     i * width, (i + 1) * width - 1, change[i]))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("device", help="serial device or pty")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=0.5)
+    parser.add_argument("command", choices=("duty", "freq", "start", "stop", "dir", "mode", "read", "telemetry",
+                                            "history", "faults", "profile", "jitter"))
+    parser.add_argument("value", nargs="?", help="duty in %%, frequency in Hz, direction 0/1, mode spi/pwm, telemetry rate")
+    args = parser.parse_args()
+
+    if args.command in ("duty", "freq", "dir", "mode", "telemetry") and args.value is None:
+        parser.error("%s needs a value" % args.command)
+    if args.command == "duty":
+        command, data = SET_DUTY, struct.pack("<H", min(0xFFFF, int(float(args.value) * 65536 / 100)))
+    elif args.command == "freq":
+        command, data = SET_FREQ, struct.pack("<H", int(args.value))
+    elif args.command == "dir":
+        command, data = DIR, bytes([int(args.value)])
+    elif args.command == "mode":
+        command, data = MODE, bytes([1 if args.value.lower() == "spi" else 0])
+    elif args.command == "telemetry":
+        command, data = TELEMETRY, struct.pack("<H", int(args.value))
+    else:
+        command, data = {"start": START, "stop": STOP, "read": READ, "history": HISTORY,
+                         "faults": FAULTS, "profile": PROFILE, "jitter": JITTER}[args.command], b""
+
+    fd = open_port(args.device, args.baud, os.O_RDWR)
+    if command == HISTORY:
+        sys.exit(history(fd, args.timeout))
+    if args.command == "profile":
+        sys.exit(profile(fd, args.value == "reset", args.timeout))
+    if args.command == "jitter":
+        sys.exit(jitter(fd, args.value == "reset", args.timeout))
+    status, reply = transact(fd, command, data, args.timeout)
+    print(STATUS[status] if status < len(STATUS) else "status %d" % status)
+    if command == READ and status == 0:
+        f = READ_DATA.unpack(reply)
+        print("mode=%s revision=%d diag=0x%02X control=0x%02X fault=%d running=%d dir=%d "
+              "freq=%dHz duty=%.1f%%" % ("SPI" if f[0] else "PWM", f[1], f[2], f[3], f[4], f[5], f[6],
+                                         f[7], f[8] * 100.0 / 65536))
+    if command == FAULTS and status == 0:
+        print(" ".join("%s=%d" % item for item in zip(FAULT_CLASSES, struct.unpack("<%dH" % len(FAULT_CLASSES), reply))))
+    sys.exit(0 if status == 0 else 1)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except TimeoutError as error:
+        sys.exit(str(error))
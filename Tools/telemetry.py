@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Decodes the AVR64DD32-TLE9201SG telemetry stream (Telemetry.c).
+
+Reads COBS frames terminated by 0x00 from a serial device or pty, checks the
+CRC-16/CCITT-FALSE and prints one line per frame.
+
+    telemetry.py /dev/ttyUSB0
+    telemetry.py --baud 115200 /dev/pts/3
+"""
+
+import argparse
+import os
+import struct
+import sys
+import termios
+import tty
+
+TELEMETRY_TYPE = 0x01
+PAYLOAD = struct.Struct("<BBIBBBBBBBBHHHHH")
+FIELDS = ("type", "sequence", "ticks", "mode", "revision", "diag", "control", "fault",
+          "direction", "running", "ramp", "pwm_freq", "duty_cycle", "duty", "rpm", "current")
+RTC_TICK_HZ = 1024
+RAMP_STATES = ("IDLE", "RUN", "BRAKE", "REVERSE", "DEADTIME")
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, same as _crc_xmodem_update() from 0xFFFF."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    """Decodes one COBS frame without its delimiter, None if malformed."""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame) + 1:
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def cobs_encode(data):
+    """Encodes one COBS frame and appends the 0x00 delimiter."""
+    out = bytearray()
+    block = bytearray()
+    for byte in data:
+        if byte:
+            block.append(byte)
+            if len(block) == 0xFE:
+                out += bytes([0xFF]) + block
+                block = bytearray()
+        else:
+            out += bytes([len(block) + 1]) + block
+            block = bytearray()
+    out += bytes([len(block) + 1]) + block
+    return bytes(out) + b"\0"
+
+
+def open_port(path, baud, flags=os.O_RDONLY):
+    fd = os.open(path, flags | os.O_NOCTTY)
+    if os.isatty(fd):
+        speed = getattr(termios, "B%d" % baud, None)
+        if speed is None:
+            sys.exit("unsupported baud rate %d" % baud)
+        tty.setraw(fd)
+        attrs = termios.tcgetattr(fd)
+        attrs[4] = attrs[5] = speed
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def show(payload):
+    f = dict(zip(FIELDS, PAYLOAD.unpack(payload)))
+    ramp = RAMP_STATES[f["ramp"]] if f["ramp"] < len(RAMP_STATES) else f["ramp"]
+    print("#%3d %10.3fs %s diag=0x%02X ctrl=0x%02X fault=%d dir=%d run=%d ramp=%-8s "
+          "f=%5dHz duty=%5.1f%%/%5.1f%% rpm=%5d I=%4d" % (
+              f["sequence"], f["ticks"] / RTC_TICK_HZ, "SPI" if f["mode"] else "PWM",
+              f["diag"], f["control"], f["fault"], f["direction"], f["running"], ramp,
+              f["pwm_freq"], f["duty"] * 100.0 / 65536, f["duty_cycle"] * 100.0 / 65536,
+              f["rpm"], f["current"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("device", help="serial device or pty")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    fd = open_port(args.device, args.baud)
+    buffer = bytearray()
+    last = None
+    while True:
+        chunk = os.read(fd, 256)
+        if not chunk:
+            break
+        buffer += chunk
+        while 0 in buffer:
+            end = buffer.index(0)
+            frame, buffer = bytes(buffer[:end]), buffer[end + 1:]
+            data = cobs_decode(frame) if frame else None
+            if data is None or len(data) != PAYLOAD.size + 2:
+                print("bad frame (%d bytes)" % len(frame), file=sys.stderr)
+                continue
+            payload, crc = data[:-2], struct.unpack("<H", data[-2:])[0]
+            if crc16(payload) != crc:
+                print("CRC error", file=sys.stderr)
+                continue
+            if payload[0] != TELEMETRY_TYPE:
+                continue
+            if last is not None and (last + 1) & 0xFF != payload[1]:
+                print("lost %d frame(s)" % ((payload[1] - last - 1) & 0xFF), file=sys.stderr)
+            last = payload[1]
+            show(payload)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass